@@ -0,0 +1,57 @@
+"""
+Compare the cost of the error function paths of DL8.5: the built-in misclassification error, a native plugin
+(examples/plugins/misclassification_plugin.c) and the same error written as a Python ``fast_error_function``.
+
+Run from the root of the repository after building the package:
+    python benchmarks/bench_error_plugin.py
+"""
+import os
+import subprocess
+import sys
+import tempfile
+import time
+import numpy as np
+from dl85 import DL85Classifier
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DATASETS = ["anneal.txt", "australian-credit.txt", "german-credit.txt", "hypothyroid.txt", "kr-vs-kp.txt"]
+DEPTH = 3
+
+
+def build_plugin(directory):
+    source = os.path.join(ROOT, "examples", "plugins", "misclassification_plugin.c")
+    library = os.path.join(directory, "misclassification_plugin.so")
+    subprocess.check_call([os.environ.get("CC", "cc"), "-O2", "-shared", "-fPIC",
+                           "-I" + os.path.join(ROOT, "wrapping", "src", "headers"), source, "-o", library])
+    return library
+
+
+def fast_error(sup_iter):
+    supports = sup_iter.to_array()
+    return supports.sum() - supports.max(), supports.argmax()
+
+
+def timed_fit(X, y, **params):
+    clf = DL85Classifier(max_depth=DEPTH, **params)
+    start = time.perf_counter()
+    clf.fit(X, y)
+    return time.perf_counter() - start, clf.error_, clf.lattice_size_
+
+
+def main():
+    with tempfile.TemporaryDirectory() as directory:
+        plugin = build_plugin(directory)
+        print("%-24s %12s %12s %12s %10s" % ("dataset", "builtin(s)", "plugin(s)", "python(s)", "nodes"))
+        for name in DATASETS:
+            dataset = np.genfromtxt(os.path.join(ROOT, "datasets", name), delimiter=' ')
+            X, y = dataset[:, 1:].astype('int32'), dataset[:, 0].astype('int32')
+            builtin = timed_fit(X, y)
+            native = timed_fit(X, y, error_plugin=plugin)
+            python = timed_fit(X, y, fast_error_function=fast_error)
+            if not builtin[1] == native[1] == python[1]:
+                sys.exit("different errors on %s: %s %s %s" % (name, builtin[1], native[1], python[1]))
+            print("%-24s %12.3f %12.3f %12.3f %10d" % (name, builtin[0], native[0], python[0], builtin[2]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,71 @@
+"""
+Measure the search of DL8.5 on large random data with the bitsets of the data and of the covers on huge pages and on
+ordinary pages. Each search runs in a fresh process, under perf stat when it is installed to count the misses of the
+data TLB. The huge pages used by the process are those of /proc/self/smaps_rollup, which also counts the arrays of
+numpy. On a system without huge pages, both runs use ordinary pages.
+
+Run from the root of the repository after building the package:
+    python benchmarks/bench_huge_pages.py
+"""
+import os
+import shutil
+import subprocess
+import sys
+import time
+import numpy as np
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+RUNS = [(100000, 64, 2), (1000000, 64, 2), (1000000, 32, 3)]  # transactions, attributes, depth
+
+
+def huge_pages_kb():
+    try:
+        with open("/proc/self/smaps_rollup") as smaps:
+            return sum(int(line.split()[1]) for line in smaps if line.startswith(("AnonHugePages", "Private_Hugetlb")))
+    except OSError:
+        return 0
+
+
+def measure(ntransactions, nattributes, depth, huge):
+    import dl85Optimizer
+    dl85Optimizer.set_huge_pages(huge)
+    random = np.random.RandomState(0)
+    X = random.randint(0, 2, (ntransactions, nattributes), dtype='int32')
+    y = random.randint(0, 2, ntransactions, dtype='int32')
+    before = huge_pages_kb()
+    solver = dl85Optimizer.Solver(X, y)
+    start = time.perf_counter()
+    solver.solve(max_depth=depth)
+    print(time.perf_counter() - start, huge_pages_kb() - before)
+
+
+def run(ntransactions, nattributes, depth, huge):
+    env = dict(os.environ, PYTHONPATH=os.pathsep.join([ROOT] + sys.path))
+    command = [sys.executable, __file__, str(ntransactions), str(nattributes), str(depth), str(int(huge))]
+    perf = shutil.which("perf")
+    if perf:
+        command = [perf, "stat", "-x", ",", "-e", "dTLB-load-misses"] + command
+    process = subprocess.run(command, cwd=ROOT, env=env, stdout=subprocess.PIPE, stderr=subprocess.PIPE, check=True)
+    elapsed, huge_kb = process.stdout.decode().split()[-2:]
+    misses = None
+    for line in process.stderr.decode().splitlines():
+        if "dTLB-load-misses" in line and line.split(",")[0].isdigit():
+            misses = int(line.split(",")[0])
+    return float(elapsed), int(huge_kb), misses
+
+
+def main():
+    print("%-12s %10s %6s %6s %10s %12s %16s" % ("transactions", "attributes", "depth", "huge", "time(s)", "huge(MB)",
+                                                  "dTLB misses"))
+    for ntransactions, nattributes, depth in RUNS:
+        for huge in (False, True):
+            elapsed, huge_kb, misses = run(ntransactions, nattributes, depth, huge)
+            print("%-12d %10d %6d %6s %10.3f %12.1f %16s" % (ntransactions, nattributes, depth, huge, elapsed,
+                                                            huge_kb / 1024, "-" if misses is None else misses))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) == 5:
+        measure(int(sys.argv[1]), int(sys.argv[2]), int(sys.argv[3]), sys.argv[4] == "1")
+    else:
+        main()
@@ -0,0 +1,46 @@
+"""
+Measure the memory used by the cache of DL8.5 per explored node. Each fit runs in a fresh process and the growth of its
+peak resident set size during the fit is divided by the number of nodes of the lattice.
+
+Run from the root of the repository after building the package:
+    python benchmarks/bench_node_memory.py
+"""
+import os
+import resource
+import subprocess
+import sys
+import numpy as np
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+RUNS = [("anneal.txt", 4), ("german-credit.txt", 3), ("hypothyroid.txt", 3), ("vote.txt", 5)]
+
+
+def peak_rss():
+    rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return rss if sys.platform == "darwin" else rss * 1024  # bytes on macOS, kilobytes elsewhere
+
+
+def measure(name, depth):
+    from dl85 import DL85Classifier
+    dataset = np.genfromtxt(os.path.join(ROOT, "datasets", name), delimiter=' ')
+    X, y = dataset[:, 1:].astype('int32'), dataset[:, 0].astype('int32')
+    clf = DL85Classifier(max_depth=depth)
+    before = peak_rss()
+    clf.fit(X, y)
+    print(clf.lattice_size_, peak_rss() - before)
+
+
+def main():
+    print("%-24s %6s %12s %12s %14s" % ("dataset", "depth", "nodes", "memory(MB)", "bytes/node"))
+    for name, depth in RUNS:
+        env = dict(os.environ, PYTHONPATH=os.pathsep.join([ROOT] + sys.path))
+        output = subprocess.check_output([sys.executable, __file__, name, str(depth)], cwd=ROOT, env=env)
+        nodes, memory = map(int, output.decode().split()[-2:])
+        print("%-24s %6d %12d %12.1f %14.1f" % (name, depth, nodes, memory / 2 ** 20, memory / nodes))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) == 3:
+        measure(sys.argv[1], int(sys.argv[2]))
+    else:
+        main()
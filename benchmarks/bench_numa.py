@@ -0,0 +1,48 @@
+"""
+Measure the time of the parallel cross-validations of DL8.5 with the data replicated on each NUMA node, the threads
+reading their local replica, and with a single copy of the data, which the threads of the other nodes read remotely.
+In both cases the threads are pinned to their node. Each configuration is run several times and the fastest run is
+kept. On a host of a single node, both runs read the same data and the times only differ by noise.
+
+Run from the root of the repository after building the package:
+    python benchmarks/bench_numa.py
+"""
+import os
+import time
+import numpy as np
+import dl85Optimizer
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+RUNS = [("anneal.txt", 3), ("german-credit.txt", 2), ("kr-vs-kp.txt", 3)]
+NFOLDS = 8
+REPEAT = 3
+
+
+def fastest(solver, folds, depth):
+    best = None
+    for _ in range(REPEAT):
+        start = time.perf_counter()
+        solver.cross_validate(folds, max_depth=depth)
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def main():
+    nodes = dl85Optimizer.numa_nodes()
+    print("NUMA nodes: %d, cpus per node: %s" % (len(nodes), [len(cpus) for cpus in nodes]))
+    print("%-24s %6s %12s %12s %10s" % ("dataset", "depth", "shared(s)", "replicas(s)", "speedup"))
+    for name, depth in RUNS:
+        dataset = np.genfromtxt(os.path.join(ROOT, "datasets", name), delimiter=' ')
+        X, y = dataset[:, 1:].astype('int32'), dataset[:, 0].astype('int32')
+        folds = np.arange(len(y)) % NFOLDS
+        solver = dl85Optimizer.Solver(X, y)
+        solver.numa_replicas = False
+        shared = fastest(solver, folds, depth)
+        solver.numa_replicas = True
+        replicated = fastest(solver, folds, depth)
+        print("%-24s %6d %12.3f %12.3f %10.2f" % (name, depth, shared, replicated, shared / replicated))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,36 @@
+"""
+Measure the time spent by the search of DL8.5 per node of the lattice, with the default misclassification error.
+Each configuration is fitted several times and the fastest run is kept.
+
+Run from the root of the repository after building the package:
+    python benchmarks/bench_search_core.py
+"""
+import os
+import time
+import numpy as np
+from dl85 import DL85Classifier
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+RUNS = [("anneal.txt", 3, {}), ("german-credit.txt", 3, {}), ("hypothyroid.txt", 3, {}),
+        ("vote.txt", 4, {"iterative": True}), ("kr-vs-kp.txt", 3, {"desc": True})]
+REPEAT = 3
+
+
+def main():
+    print("%-24s %6s %10s %12s %10s %10s" % ("dataset", "depth", "options", "nodes", "time(s)", "ns/node"))
+    for name, depth, options in RUNS:
+        dataset = np.genfromtxt(os.path.join(ROOT, "datasets", name), delimiter=' ')
+        X, y = dataset[:, 1:].astype('int32'), dataset[:, 0].astype('int32')
+        best = None
+        for _ in range(REPEAT):
+            clf = DL85Classifier(max_depth=depth, **options)
+            start = time.perf_counter()
+            clf.fit(X, y)
+            elapsed = time.perf_counter() - start
+            best = elapsed if best is None else min(best, elapsed)
+        print("%-24s %6d %10s %12d %10.3f %10.1f" % (name, depth, ",".join(options) or "-", clf.lattice_size_, best,
+                                                     best * 1e9 / clf.lattice_size_))
+
+
+if __name__ == "__main__":
+    main()
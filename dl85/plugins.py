@@ -0,0 +1,69 @@
+"""ctypes description of the native error function plugins (see ``wrapping/src/headers/error_plugin.h``).
+
+A plugin can be given to ``error_plugin`` either as the path of a shared library exporting a ``dl85_error_plugin``
+structure, or as an ``ErrorPlugin`` structure built in memory, for instance from ``numba.cfunc`` addresses.
+"""
+import ctypes
+
+ABI_VERSION = 1
+
+INIT_FUNCTION = ctypes.CFUNCTYPE(ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int, ctypes.c_int,
+                                 ctypes.POINTER(ctypes.c_int))
+NODE_ERROR_FUNCTION = ctypes.CFUNCTYPE(ctypes.c_float, ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64), ctypes.c_int,
+                                       ctypes.POINTER(ctypes.c_int), ctypes.c_int, ctypes.POINTER(ctypes.c_int))
+LOWER_BOUND_FUNCTION = ctypes.CFUNCTYPE(ctypes.c_float, ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64), ctypes.c_int,
+                                        ctypes.POINTER(ctypes.c_int), ctypes.c_int)
+DESTROY_FUNCTION = ctypes.CFUNCTYPE(None, ctypes.c_void_p)
+
+
+class ErrorPlugin(ctypes.Structure):
+    _fields_ = [("abi_version", ctypes.c_int),
+                ("needs_cover", ctypes.c_int),
+                ("user_data", ctypes.c_void_p),
+                ("init", INIT_FUNCTION),
+                ("node_error", NODE_ERROR_FUNCTION),
+                ("lower_bound", LOWER_BOUND_FUNCTION),
+                ("destroy", DESTROY_FUNCTION)]
+
+
+def make_error_plugin(node_error, lower_bound=None, init=None, destroy=None, needs_cover=False, user_data=None):
+    """Build an ``ErrorPlugin`` structure.
+
+    Each function is either the address of a C function with the signature of the plugin interface
+    (e.g. ``numba.cfunc(...).address``) or a Python callable. Python callables are called through ctypes and
+    therefore hold the GIL, they are mostly useful for testing.
+
+    Parameters
+    ----------
+    node_error : int or callable
+        ``node_error(state, words, nwords, supports, nclasses, prediction) -> float``
+    lower_bound : int or callable, default=None
+        ``lower_bound(state, words, nwords, supports, nclasses) -> float``. No lower bound is used if None.
+    init : int or callable, default=None
+        ``init(user_data, ntransactions, nclasses, class_supports) -> state``
+    destroy : int or callable, default=None
+        ``destroy(state)``
+    needs_cover : bool, default=False
+        Whether ``words`` must be filled with the cover of the node.
+    user_data : int, default=None
+        Pointer given to ``init``.
+
+    Returns
+    -------
+    plugin : ErrorPlugin
+    """
+    def wrap(function_type, function):
+        if function is None:
+            return function_type()
+        if isinstance(function, int):
+            return ctypes.cast(ctypes.c_void_p(function), function_type)
+        return function_type(function)
+
+    plugin = ErrorPlugin(abi_version=ABI_VERSION,
+                         needs_cover=int(needs_cover),
+                         user_data=user_data,
+                         init=wrap(INIT_FUNCTION, init),
+                         node_error=wrap(NODE_ERROR_FUNCTION, node_error),
+                         lower_bound=wrap(LOWER_BOUND_FUNCTION, lower_bound),
+                         destroy=wrap(DESTROY_FUNCTION, destroy))
+    return plugin
@@ -36,6 +36,22 @@ class DL85Predictor(BaseEstimator):
         A parameter used to indicate if only optimal solutions should be stored in the cache.
     print_output : bool, default=False
         A parameter used to indicate if the search output will be printed or not
+    error_plugin : str or ErrorPlugin, default=None
+        Native error function used instead of the misclassification error. Either the path of a shared library
+        exporting a ``dl85_error_plugin`` structure or an ``ErrorPlugin`` built with ``dl85.plugins.make_error_plugin``
+    anytime : bool, default=False
+        Whether the most promising items are explored first at each level of the lattice, so that good trees are
+        found early. Ignored if desc or asc is set
+    solution_callback : function, default=None
+        Function called with each tree improving the best one found so far. It receives the tree as a dict, its
+        error, a lower bound of the optimal error and the relative gap between the two. The lower bound comes from
+        the attributes left to explore at the root, bounded by the error of their leaves at depth 1 and otherwise by
+        the lower bounds of the error function. If it returns True, the search stops and this tree is returned as the
+        solution of a search which reached the time limit
+    max_leaves : int, default=None
+        Maximum number of leaves of the tree. The search then keeps for each node its best subtree of each number
+        of leaves, and cuts the branches left with a single leaf. Only with the misclassification error; the prior
+        tree of a warm start is not used
 
     Attributes
     ----------
@@ -75,7 +91,11 @@ class DL85Predictor(BaseEstimator):
             repeat_sort=False,
             leaf_value_function=None,
             nps=False,
-            print_output=False):
+            print_output=False,
+            error_plugin=None,
+            anytime=False,
+            solution_callback=None,
+            max_leaves=None):
         self.max_depth = max_depth
         self.min_sup = min_sup
         self.error_function = error_function
@@ -91,12 +111,16 @@ class DL85Predictor(BaseEstimator):
         self.leaf_value_function = leaf_value_function
         self.nps = nps
         self.print_output = print_output
+        self.error_plugin = error_plugin
+        self.anytime = anytime
+        self.solution_callback = solution_callback
+        self.max_leaves = max_leaves
 
     def _more_tags(self):
         return {'X_types': 'categorical',
                 'allow_nan': False}
 
-    def fit(self, X, y=None, warm=None):
+    def fit(self, X, y=None, warm=None, warm_tree=None):
         """Implements the standard fitting function for a DL8.5 classifier.
 
         Parameters
@@ -105,6 +129,12 @@ class DL85Predictor(BaseEstimator):
             The training input samples.
         y : array-like, shape (n_samples,)
             The target values. An array of int.
+        warm : array-like, shape (n_samples,), default=None
+            Predictions of a prior model, used to bound the error of the nodes.
+        warm_tree : dict, default=None
+            Prior tree, such as the ``tree_`` of a previous fit. Its tests are explored first. With the
+            misclassification error, its subtrees are also evaluated on X to bound the error of the nodes of their
+            paths.
 
         Returns
         -------
@@ -162,7 +192,12 @@ class DL85Predictor(BaseEstimator):
                                        repeat_sort=self.repeat_sort,
                                        bin_save=False,
                                        nps=self.nps,
-                                       predictor=predict)
+                                       predictor=predict,
+                                       error_plugin=self.error_plugin,
+                                       anytime=self.anytime,
+                                       solution_callback=self.solution_callback,
+                                       warm_tree=None if warm_tree is None else self.flatten_tree(warm_tree),
+                                       max_leaves=0 if self.max_leaves is None else self.max_leaves)
 
         # if self.print_output:
         #     print(solution)
@@ -317,6 +352,21 @@ class DL85Predictor(BaseEstimator):
                 node = node['right']
         return node['value']
 
+    @staticmethod
+    def flatten_tree(tree):
+        """Return the tree in the preorder read by the search: the feature of each test followed by its subtree for
+        the value 1 (its 'left' child) then its subtree for the value 0, and -1 for each leaf."""
+        nodes, stack = [], [tree]
+        while stack:
+            node = stack.pop()
+            if DL85Predictor.is_leaf_node(node):
+                nodes.append(-1)
+            else:
+                nodes.append(int(node['feat']))
+                stack.append(node['right'])
+                stack.append(node['left'])
+        return nodes
+
     @staticmethod
     def is_leaf_node(node):
         names = [x[0] for x in node.items()]
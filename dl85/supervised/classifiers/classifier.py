@@ -32,6 +32,22 @@ class DL85Classifier(DL85Predictor, ClassifierMixin):
         A parameter used to indicate if only optimal solutions should be stored in the cache.
     print_output : bool, default=False
         A parameter used to indicate if the search output will be printed or not
+    error_plugin : str or ErrorPlugin, default=None
+        Native error function used instead of the misclassification error. Either the path of a shared library
+        exporting a ``dl85_error_plugin`` structure or an ``ErrorPlugin`` built with ``dl85.plugins.make_error_plugin``
+    anytime : bool, default=False
+        Whether the items with the highest information gain are explored first at each level of the lattice, so that
+        good trees are found early. Ignored if desc or asc is set
+    solution_callback : function, default=None
+        Function called with each tree improving the best one found so far. It receives the tree as a dict, its
+        error, a lower bound of the optimal error and the relative gap between the two. The lower bound comes from
+        the attributes left to explore at the root, bounded by the error of their leaves at depth 1 and otherwise by
+        the lower bounds of the error function. If it returns True, the search stops and this tree is returned as the
+        solution of a search which reached the time limit
+    max_leaves : int, default=None
+        Maximum number of leaves of the tree. The search then keeps for each node its best subtree of each number
+        of leaves, and cuts the branches left with a single leaf. Only with the misclassification error; the prior
+        tree of a warm start is not used
 
     Attributes
     ----------
@@ -70,7 +86,11 @@ class DL85Classifier(DL85Predictor, ClassifierMixin):
             asc=False,
             repeat_sort=False,
             nps=False,
-            print_output=False):
+            print_output=False,
+            error_plugin=None,
+            anytime=False,
+            solution_callback=None,
+            max_leaves=None):
 
         DL85Predictor.__init__(self,
                                max_depth=max_depth,
@@ -87,4 +107,8 @@ class DL85Classifier(DL85Predictor, ClassifierMixin):
                                repeat_sort=repeat_sort,
                                leaf_value_function=None,
                                nps=nps,
-                               print_output=print_output)
+                               print_output=print_output,
+                               error_plugin=error_plugin,
+                               anytime=anytime,
+                               solution_callback=solution_callback,
+                               max_leaves=max_leaves)
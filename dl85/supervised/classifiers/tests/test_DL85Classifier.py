@@ -2,11 +2,26 @@ from sklearn.utils.estimator_checks import check_estimator
 from sklearn.model_selection import train_test_split
 from ..classifier import DL85Classifier
 import numpy as np
+import time
+import pytest
 from random import randrange
 from os import listdir
 from os.path import isfile, join
 from sklearn.metrics import accuracy_score
 
+# datasets small enough to be searched several times in a test, Python error functions included
+SMALL_DATASETS = ["anneal.txt", "hepatitis.txt", "lymph.txt", "vote.txt", "zoo-1.txt"]
+
+
+def load(file):
+    dataset = np.genfromtxt(join("datasets", file), delimiter=' ')
+    return dataset[:, 1:].astype('int32'), dataset[:, 0].astype('int32')
+
+
+@pytest.fixture(params=SMALL_DATASETS)
+def data(request):
+    return load(request.param)
+
 
 def test_fit():
     dataset = np.genfromtxt("datasets/anneal.txt", delimiter=' ')
@@ -90,4 +105,421 @@ def test_depth_3():
         assert clf.error_ == int(X.shape[0] - X.shape[0] * accuracy_score(y, y_pred))
 
 
+def test_error_function_array_view(data):
+    X, y = data
+
+    def error(tids):
+        tids_array = tids.to_array()
+        words = tids.to_words()
+        assert tids_array.dtype == np.int32 and not tids_array.flags.writeable
+        assert sorted(tids_array.tolist()) == sorted(list(tids))
+        assert sum(bin(int(w)).count("1") for w in words) == len(tids_array)
+        assert all((int(words[t // 64]) >> int(t % 64)) & 1 for t in tids_array)
+        supports = np.bincount(y[tids_array], minlength=2)
+        return len(tids_array) - supports.max(), supports.argmax()
+
+    def fast_error(sup_iter):
+        supports = sup_iter.to_array()
+        assert supports.tolist() == list(sup_iter)
+        return supports.sum() - supports.max(), supports.argmax()
+
+    clf = DL85Classifier(max_depth=2)
+    clf.fit(X, y)
+    clf_user = DL85Classifier(max_depth=2, error_function=error)
+    clf_user.fit(X, y)
+    clf_fast = DL85Classifier(max_depth=2, fast_error_function=fast_error)
+    clf_fast.fit(X, y)
+    assert clf_user.error_ == clf.error_
+    assert clf_fast.error_ == clf.error_
+
+
+def test_error_plugin(data):
+    from ....plugins import make_error_plugin
+    X, y = data
+
+    def node_error(state, words, nwords, supports, nclasses, prediction):
+        counts = [supports[c] for c in range(nclasses)]
+        prediction[0] = counts.index(max(counts))
+        return sum(counts) - max(counts)
+
+    def fast_error(sup_iter):
+        supports = sup_iter.to_array()
+        return supports.sum() - supports.max(), supports.argmax()
+
+    clf = DL85Classifier(max_depth=2)
+    clf.fit(X, y)
+    clf_plugin = DL85Classifier(max_depth=2, error_plugin=make_error_plugin(node_error))
+    clf_plugin.fit(X, y)
+    assert clf_plugin.error_ == clf.error_
+    # the search of a plugin is the one of a Python error function, without the greedy bound of the native errors
+    clf_fast = DL85Classifier(max_depth=2, fast_error_function=fast_error)
+    clf_fast.fit(X, y)
+    assert clf_plugin.lattice_size_ == clf_fast.lattice_size_
+
+
+def test_native_error_plugin(tmp_path, monkeypatch):
+    import shutil
+    import subprocess
+    compiler = shutil.which("cc") or shutil.which("gcc")
+    if compiler is None:
+        pytest.skip("no C compiler to build the sample plugin")
+    X, y = load("anneal.txt")
+
+    # the sample plugin is built as its comment tells
+    library = str(tmp_path / "misclassification_plugin.so")
+    subprocess.run([compiler, "-O2", "-shared", "-fPIC", "-I" + join("wrapping", "src", "headers"),
+                    join("examples", "plugins", "misclassification_plugin.c"), "-o", library], check=True)
+
+    # with unit costs, it is the misclassification error
+    clf = DL85Classifier(max_depth=2)
+    clf.fit(X, y)
+    clf_plugin = DL85Classifier(max_depth=2, error_plugin=library)
+    clf_plugin.fit(X, y)
+    assert clf_plugin.error_ == clf.error_
+
+    # the errors on the class 1 cost five times more
+    monkeypatch.setenv("DL85_CLASS_COSTS", "1,5")
+    clf_costs = DL85Classifier(max_depth=2, error_plugin=library)
+    clf_costs.fit(X, y)
+    wrong = clf_costs.predict(X) != y
+    assert clf_costs.error_ == (wrong & (y == 0)).sum() + 5 * (wrong & (y == 1)).sum()
+
+
+def test_concurrent_fits():
+    from concurrent.futures import ThreadPoolExecutor
+    datasets = [load(file) for file in SMALL_DATASETS]
+
+    def fit(data):
+        clf = DL85Classifier(max_depth=2, min_sup=2)
+        clf.fit(*data)
+        return clf.error_, clf.lattice_size_
+
+    sequential = [fit(data) for data in datasets]
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        concurrent = list(pool.map(fit, datasets * 2))
+    assert concurrent == sequential * 2
+
+    # the time limit and the run time of each fit are in wall time, not charged with the time of the other fits
+    def timed_fit(data):
+        start = time.perf_counter()
+        clf = DL85Classifier(max_depth=3, time_limit=60)
+        clf.fit(*data)
+        return clf.timeout_, clf.runtime_ <= time.perf_counter() - start
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        assert list(pool.map(timed_fit, datasets * 2)) == [(False, True)] * 10
+
+
+def test_anytime_solution_callback():
+    X, y = load("anneal.txt")
+
+    solutions = []
+    clf = DL85Classifier(max_depth=3, anytime=True, solution_callback=lambda *solution: solutions.append(solution))
+    clf.fit(X, y)
+    errors = [error for tree, error, lower_bound, gap in solutions]
+    assert errors == sorted(set(errors), reverse=True)
+    assert errors[-1] == clf.error_ and clf.timeout_ is False
+    assert all(lower_bound <= clf.error_ for tree, error, lower_bound, gap in solutions)
+
+    # at depth 1, the leaves of the attributes left bound the error exactly, so that the optimal tree has no gap
+    solutions = []
+    clf_stump = DL85Classifier(max_depth=1, anytime=True, solution_callback=lambda *solution: solutions.append(solution))
+    clf_stump.fit(X, y)
+    assert solutions[-1][1:] == (clf_stump.error_, clf_stump.error_, 0)
+
+    # the search stops at the first tree found when the callback asks for it
+    first = []
+    clf_stopped = DL85Classifier(max_depth=3, anytime=True, solution_callback=lambda *solution: first.append(solution) or True)
+    clf_stopped.fit(X, y)
+    assert len(first) == 1 and first[0][0] == clf_stopped.tree_ and first[0][1] == clf_stopped.error_
+    assert clf_stopped.timeout_ is True and clf_stopped.lattice_size_ < clf.lattice_size_
+
+
+def test_penalized_error(data):
+    X, y = data
+
+    # with a cost per leaf, a split may cost more than the leaf. The search still splits wherever it can, so that only
+    # the trees splitting as much bound it
+    def leaves(node):
+        return 1 if "value" in node else leaves(node["left"]) + leaves(node["right"])
+
+    def error(tids):
+        supports = np.bincount(y[tids.to_array()], minlength=2)
+        return supports.sum() - supports.max() + 3, supports.argmax()
+
+    def fast_error(sup_iter):
+        supports = sup_iter.to_array()
+        return supports.sum() - supports.max() + 3, supports.argmax()
+
+    clf_user = DL85Classifier(max_depth=2, error_function=error)
+    clf_user.fit(X, y)
+    clf_fast = DL85Classifier(max_depth=2, fast_error_function=fast_error)
+    clf_fast.fit(X, y)
+    assert clf_fast.tree_ is not None
+    assert clf_fast.error_ == clf_user.error_
+    assert clf_fast.error_ == (clf_fast.predict(X) != y).sum() + 3 * leaves(clf_fast.tree_)
+
+
+def test_warm_tree():
+    X, y = load("anneal.txt")
+
+    # the tree learnt on a part of the data seeds the search on all of them
+    prior = DL85Classifier(max_depth=3)
+    prior.fit(X[:-40], y[:-40])
+    cold = DL85Classifier(max_depth=3)
+    cold.fit(X, y)
+    warm = DL85Classifier(max_depth=3)
+    warm.fit(X, y, warm_tree=prior.tree_)
+    assert warm.error_ == cold.error_
+    assert warm.lattice_size_ <= cold.lattice_size_
+
+    # with a cost per leaf, the leaves of the prior tree do not bound the splits which the search makes instead
+    def fast_error(sup_iter):
+        supports = sup_iter.to_array()
+        return supports.sum() - supports.max() + 60, supports.argmax()
+
+    prior = DL85Classifier(max_depth=2)
+    prior.fit(X, y)
+    cold = DL85Classifier(max_depth=2, fast_error_function=fast_error)
+    cold.fit(X, y)
+    warm = DL85Classifier(max_depth=2, fast_error_function=fast_error)
+    warm.fit(X, y, warm_tree=prior.tree_)
+    assert warm.tree_ is not None
+    assert warm.error_ == cold.error_
+
+
+def test_solver(data):
+    import dl85Optimizer
+    X, y = data
+
+    def result(out):
+        lines = dict(line.split(": ", 1) for line in out.splitlines() if ": " in line)
+        return lines["Error"], int(lines["LatticeSize"])
+
+    # the cache of a search answers the same search and bounds the searches with a larger depth
+    solver = dl85Optimizer.Solver(X, y)
+    first = result(solver.solve(max_depth=3, min_sup=1))
+    assert result(solver.solve(max_depth=3, min_sup=1)) == (first[0], 0)
+    deeper = result(solver.solve(max_depth=4, min_sup=1))
+    cold = result(dl85Optimizer.solve(X, y, None, max_depth=4, min_sup=1))
+    assert deeper[0] == cold[0]
+    assert deeper[1] <= cold[1]
+
+    # the searches of several threads on the same solver wait for each other instead of sharing its cache
+    from concurrent.futures import ThreadPoolExecutor
+    depths = [1, 2, 3, 1, 2, 3]
+    with ThreadPoolExecutor(max_workers=3) as pool:
+        errors = list(pool.map(lambda depth: result(solver.solve(max_depth=depth))[0], depths))
+    assert errors == [result(dl85Optimizer.solve(X, y, None, max_depth=depth))[0] for depth in depths]
+
+    # the best tree of the misclassification error does not warm start the searches of another error function
+    def fast_error(sup_iter):
+        supports = sup_iter.to_array()
+        return supports.sum() - supports.max() + 60, supports.argmax()
+
+    solver = dl85Optimizer.Solver(X, y)
+    solver.solve(max_depth=2)
+    penalized = result(solver.solve(fast_func=fast_error, max_depth=2))
+    assert penalized[0] == result(dl85Optimizer.solve(X, y, None, fast_func=fast_error, max_depth=2))[0]
+
+
+def test_sweep(data):
+    import dl85Optimizer
+    X, y = data
+
+    def error(out):
+        return dict(line.split(": ", 1) for line in out.splitlines() if ": " in line).get("Error")
+
+    configurations = [(1, 1), (2, 1), (3, 1), (2, 20)]
+    results = dl85Optimizer.Solver(X, y).sweep(configurations)
+    for depth, min_sup in configurations:
+        assert error(results[(depth, min_sup)]) == error(dl85Optimizer.solve(X, y, None, max_depth=depth, min_sup=min_sup))
+
+
+def test_cross_validate(data):
+    import dl85Optimizer
+    X, y = data
+    folds = np.arange(len(y)) % 4
+
+    def predict(tree, x):
+        while "value" not in tree:
+            tree = tree["left"] if x[tree["feat"]] == 1 else tree["right"]
+        return tree["value"]
+
+    # each fold gives the tree learnt on the other transactions, evaluated on its own
+    results = dl85Optimizer.Solver(X, y).cross_validate(folds, max_depth=2, n_jobs=2)
+    assert len(results) == 4
+    for fold, result in enumerate(results):
+        train, test = folds != fold, folds == fold
+        clf = DL85Classifier(max_depth=2)
+        clf.fit(X[train], y[train])
+        assert result["error"] == clf.error_
+        assert result["validation_error"] == sum(predict(result["tree"], x) != c for x, c in zip(X[test], y[test]))
+
+
+def test_ensemble():
+    import dl85Optimizer
+    X, y = load("anneal.txt")
+    solver = dl85Optimizer.Solver(X, y)
+
+    # a single tree on all the data is the tree of the classifier
+    single = solver.train_ensemble(n_estimators=1, bootstrap=False, max_depth=2)
+    clf = DL85Classifier(max_depth=2)
+    clf.fit(X, y)
+    assert single.results[0]["error"] == clf.error_
+    assert np.array_equal(single.predict(X), clf.predict(X))
+
+    forest = solver.train_ensemble(n_estimators=8, max_features=0.5, random_state=0, max_depth=2, n_jobs=2)
+    assert len(forest.results) == 8
+    assert all(result["validation_error"] is not None for result in forest.results)
+    assert accuracy_score(y, forest.predict(X)) >= 0.8
+
+    # the time limit of each tree is in wall time, not charged with the time of the other threads
+    limited = solver.train_ensemble(n_estimators=8, max_features=0.5, random_state=0, max_depth=2, n_jobs=2,
+                                    time_limit=60)
+    assert not any(result["timeout"] for result in limited.results)
+    assert [r["tree"] for r in limited.results] == [r["tree"] for r in forest.results]
+
+
+def test_boosting():
+    import dl85Optimizer
+    X, y = load("anneal.txt")
+    solver = dl85Optimizer.Solver(X, y)
+
+    # the first round weighs the transactions equally, as the misclassification error
+    clf = DL85Classifier(max_depth=2)
+    clf.fit(X, y)
+    single = solver.boost(n_estimators=1, max_depth=2)
+    assert single.results[0]["validation_error"] == clf.error_
+    assert np.array_equal(single.predict(X), clf.predict(X))
+
+    boosted = solver.boost(n_estimators=10, max_depth=2)
+    assert 1 <= len(boosted.results) <= 10
+    assert all(result["weight"] > 0 for result in boosted.results)
+    assert accuracy_score(y, boosted.predict(X)) >= accuracy_score(y, clf.predict(X))
+
+
+def test_best_trees(data):
+    import dl85Optimizer
+    X, y = data
+    solver = dl85Optimizer.Solver(X, y)
+
+    # at depth 1, the trees are the leaf and the tests better than it, whose errors are computed directly
+    leaf = len(y) - np.bincount(y).max()
+    errors = [leaf]
+    for attribute in range(X.shape[1]):
+        if X[:, attribute].min() == X[:, attribute].max():
+            continue
+        error = sum(len(y[mask]) - np.bincount(y[mask]).max() for mask in (X[:, attribute] == 0, X[:, attribute] == 1))
+        if error < leaf:
+            errors.append(error)
+    best = solver.best_trees(k=5, max_depth=1)
+    assert [tree["error"] for tree in best["trees"]] == sorted(errors)[:5]
+
+    clf = DL85Classifier(max_depth=2)
+    clf.fit(X, y)
+    best = solver.best_trees(k=10, max_depth=2)
+    assert len(best["trees"]) == 10
+    assert best["trees"][0]["error"] == clf.error_
+    assert all(a["error"] <= b["error"] for a, b in zip(best["trees"], best["trees"][1:]))
+
+    rashomon = solver.best_trees(k=1000, epsilon=3, max_depth=2)
+    assert all(tree["error"] <= clf.error_ + 3 for tree in rashomon["trees"])
+    assert [tree["error"] for tree in rashomon["trees"][:10]] == [tree["error"] for tree in best["trees"]]
+
+
+
+def test_pareto_front(data):
+    import dl85Optimizer
+    X, y = data
+    solver = dl85Optimizer.Solver(X, y)
+
+    front = solver.pareto_front(max_depth=2)["trees"]
+    errors = [tree["error"] for tree in front]
+    sizes = [tree["size"] for tree in front]
+    assert errors == sorted(set(errors)) and sizes == sorted(set(sizes), reverse=True)
+    # the ends of the front are the optimal tree and the leaf, and the best tree of 3 nodes is the one of depth 1
+    for depth, size in ((2, sizes[0]), (1, 3), (0, 1)):
+        clf = DL85Classifier(max_depth=depth)
+        clf.fit(X, y)
+        assert min(tree["error"] for tree in front if tree["size"] <= size) == clf.error_
+
+
+def test_max_leaves(data):
+    import dl85Optimizer
+    X, y = data
+
+    def leaves(node):
+        return 1 if "value" in node else leaves(node["left"]) + leaves(node["right"])
+
+    front = dl85Optimizer.Solver(X, y).pareto_front(max_depth=3)["trees"]
+    for max_leaves in (2, 4, 8):
+        clf = DL85Classifier(max_depth=3, max_leaves=max_leaves)
+        clf.fit(X, y)
+        assert leaves(clf.tree_) <= max_leaves
+        assert clf.error_ == min(tree["error"] for tree in front if tree["size"] <= 2 * max_leaves - 1)
+        assert (clf.predict(X) != y).sum() == clf.error_
+    unbounded = DL85Classifier(max_depth=3)
+    unbounded.fit(X, y)
+    assert clf.error_ == unbounded.error_
+
+
+def test_checkpoint(tmp_path):
+    import dl85Optimizer
+    X, y = load("anneal.txt")
+    path = str(tmp_path / "anneal.ckpt")
+    fresh = dl85Optimizer.Solver(X, y).solve(max_depth=3).splitlines()
+
+    # the search stopped at its first tree leaves a checkpoint without the root, which the next search completes
+    dl85Optimizer.Solver(X, y).solve(max_depth=3, solution_callback=lambda *args: True, checkpoint=path)
+    solver = dl85Optimizer.Solver(X, y)
+    solver.load_checkpoint(path)
+    resumed = solver.solve(max_depth=3).splitlines()
+    assert resumed[1:6] == fresh[1:6]
+    assert int(resumed[6].split(" ")[1]) < int(fresh[6].split(" ")[1])
+
+    with pytest.raises(RuntimeError):
+        dl85Optimizer.Solver(X[:, ::-1], y).load_checkpoint(path)
+
+
+def test_sharded(data):
+    import dl85Optimizer
+    X, y = data
+    clf = DL85Classifier(max_depth=3)
+    clf.fit(X, y)
+
+    for n_processes in (1, 3):
+        solution = dl85Optimizer.Solver(X, y).solve_sharded(n_processes=n_processes, max_depth=3).splitlines()
+        assert len(solution) == 8
+        assert float(solution[4].split(" ")[1]) == clf.error_
+
+
+def test_numa_replicas(data):
+    import dl85Optimizer
+    X, y = data
+    assert len(dl85Optimizer.numa_nodes()) >= 1
+    folds = np.arange(len(y)) % 4
+
+    solver = dl85Optimizer.Solver(X, y)
+    assert solver.numa_replicas
+    replicated = solver.cross_validate(folds, max_depth=2, n_jobs=4)
+    solver.numa_replicas = False
+    shared = solver.cross_validate(folds, max_depth=2, n_jobs=4)
+    assert [r["error"] for r in replicated] == [r["error"] for r in shared]
+    assert [r["validation_error"] for r in replicated] == [r["validation_error"] for r in shared]
+
+
+def test_huge_pages():
+    import dl85Optimizer
+    random = np.random.RandomState(0)
+    X = random.randint(0, 2, (300000, 60), dtype='int32')  # columns of more than a huge page in all
+    y = (X[:, 0] ^ X[:, 1] ^ (random.rand(300000) < 0.1)).astype('int32')
+
+    outputs = []
+    for huge in (True, False):
+        dl85Optimizer.set_huge_pages(huge)
+        outputs.append(dl85Optimizer.Solver(X, y).solve(max_depth=2).splitlines()[1:6])
+    dl85Optimizer.set_huge_pages(True)
+    assert outputs[0] == outputs[1]
+
 check_estimator(DL85Classifier)
+
@@ -0,0 +1,78 @@
+/*
+ * Sample native error function for DL8.5: cost-sensitive misclassification error.
+ *
+ * Build it with
+ *     cc -O2 -shared -fPIC -I../../wrapping/src/headers misclassification_plugin.c -o misclassification_plugin.so
+ * and give the path of the library to the classifier:
+ *     DL85Classifier(max_depth=3, error_plugin="./misclassification_plugin.so")
+ *
+ * The cost of misclassifying an example of class c is 1 unless the environment variable DL85_CLASS_COSTS gives
+ * a comma separated list of costs, e.g. DL85_CLASS_COSTS=1,5 for a binary problem in which errors on class 1 are
+ * five times more expensive.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "error_plugin.h"
+
+typedef struct {
+    int nclasses;
+    float *costs;
+} State;
+
+static void *init(void *user_data, int ntransactions, int nclasses, const int *class_supports) {
+    State *state = (State *) malloc(sizeof(State));
+    const char *env = getenv("DL85_CLASS_COSTS");
+    int c;
+    (void) user_data;
+    (void) ntransactions;
+    (void) class_supports;
+    state->nclasses = nclasses;
+    state->costs = (float *) malloc(sizeof(float) * nclasses);
+    for (c = 0; c < nclasses; ++c)
+        state->costs[c] = 1;
+    for (c = 0; env != NULL && *env != '\0' && c < nclasses; ++c) {
+        char *end;
+        state->costs[c] = strtof(env, &end);
+        env = (*end == ',') ? end + 1 : end;
+    }
+    return state;
+}
+
+/* the error of a leaf predicting class p is the cost of the examples of the other classes */
+static float node_error(void *s, const uint64_t *words, int nwords, const int *supports, int nclasses,
+                        int *prediction) {
+    State *state = (State *) s;
+    float total = 0, best = -1;
+    int c;
+    (void) words;
+    (void) nwords;
+    for (c = 0; c < nclasses; ++c)
+        total += state->costs[c] * supports[c];
+    for (c = 0; c < nclasses; ++c) {
+        float kept = state->costs[c] * supports[c];
+        if (kept > best) {
+            best = kept;
+            *prediction = c;
+        }
+    }
+    return total - best;
+}
+
+static void destroy(void *s) {
+    State *state = (State *) s;
+    free(state->costs);
+    free(state);
+}
+
+#if defined(_WIN32)
+__declspec(dllexport)
+#endif
+DL85ErrorPlugin dl85_error_plugin = {
+        DL85_ERROR_PLUGIN_ABI_VERSION,
+        0, /* the class supports are enough, the cover is not needed */
+        NULL,
+        init,
+        node_error,
+        NULL, /* no lower bound */
+        destroy
+};
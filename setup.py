@@ -58,16 +58,23 @@ EXTENSION_SOURCE_FILES = ['wrapping/src/headers/error_function.pyx',
                 'wrapping/src/codes/globals.cpp',
                 'wrapping/src/codes/lcm_pruned.cpp',
                 'wrapping/src/codes/lcm_iterative.cpp',
+                'wrapping/src/codes/lcm_enumeration.cpp',
+                'wrapping/src/codes/numa.cpp',
                 'wrapping/src/codes/query.cpp',
                 'wrapping/src/codes/query_best.cpp',
-                'wrapping/src/codes/query_totalfreq.cpp',
                 'wrapping/src/codes/trie.cpp',
-                'wrapping/src/codes/dataBinaryPython.cpp']
+                'wrapping/src/codes/dataBinaryPython.cpp',
+                'wrapping/src/codes/plugin_error_function.cpp',
+                'wrapping/src/codes/arena.cpp',
+                'wrapping/src/codes/successor_cache.cpp']
 EXTENSION_INCLUDE_DIR = ['wrapping/src/headers']
 # EXTENSION_BUILD_ARGS = ['-std=c++11']
 EXTENSION_BUILD_ARGS = ['-std=c++11', '-DCYTHON_PEP489_MULTI_PHASE_INIT=0']
 if platform.system() == 'Darwin':
     EXTENSION_BUILD_ARGS.append('-mmacosx-version-min=10.12')
+if platform.system() == 'Linux':
+    EXTENSION_BUILD_ARGS.append('-pthread')  # folds of the cross-validation searched in parallel
+EXTENSION_LIBRARIES = ['dl'] if platform.system() == 'Linux' else []  # dlopen of error plugins
 
 dl85_extension = Extension(
     name=EXTENSION_NAME,
@@ -75,7 +82,8 @@ dl85_extension = Extension(
     sources=EXTENSION_SOURCE_FILES,
     include_dirs=EXTENSION_INCLUDE_DIR,  # path for headers
     extra_compile_args=EXTENSION_BUILD_ARGS,
-    extra_link_args=EXTENSION_BUILD_ARGS
+    extra_link_args=EXTENSION_BUILD_ARGS,
+    libraries=EXTENSION_LIBRARIES
 )
 
 setup(
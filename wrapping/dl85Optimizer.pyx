@@ -1,4 +1,5 @@
 from libc.stdlib cimport malloc, free
+from libc.float cimport FLT_MAX
 from libcpp.string cimport string
 from libcpp.map cimport map
 from libcpp.utility cimport pair
@@ -6,6 +7,10 @@ from libcpp cimport bool
 from libcpp.vector cimport vector
 from libcpp.functional cimport function
 import numpy as np
+import ctypes
+import json
+import os
+import threading
 
 cdef extern from "src/headers/globals.h":
     cdef cppclass Array[T]:
@@ -45,7 +50,118 @@ cdef extern from "src/headers/dl85.h":
                     bool save,
                     bool nps_param,
                     bool verbose_param,
-                    bool predict) except +
+                    bool predict,
+                    string error_plugin_path,
+                    size_t error_plugin_address,
+                    bool anytime,
+                    PySolutionWrapper solution_callback,
+                    bool solution_is_null,
+                    int *warm_tree,
+                    int warm_tree_size) except + nogil
+
+    cdef cppclass TreeResult:
+        string tree
+        float error
+        int validationError
+        int latticeSize
+        bool timeout
+
+    cdef cppclass RankedTree:
+        string tree
+        float error
+        int size
+        int depth
+
+    cdef cppclass CEnsemble "Ensemble":
+        void predict(const int *data, int ntransactions, int nattributes, int *predictions) nogil const
+        vector[vector[int]] trees
+        vector[float] weights
+
+    cdef cppclass CSolver "Solver":
+        CSolver(int* supports, int ntransactions, int nattributes, int nclasses, int *data, int *target,
+                int *warm) except +
+        string solve(float maxError,
+                     bool stopAfterError,
+                     bool iterative,
+                     PyErrorWrapper error_callback,
+                     PyFastErrorWrapper fast_error_callback,
+                     PyPredictorErrorWrapper predictor_error_callback,
+                     bool error_is_null,
+                     bool fast_error_is_null,
+                     int maxdepth,
+                     int minsup,
+                     bool infoGain,
+                     bool infoAsc,
+                     bool repeatSort,
+                     int timeLimit,
+                     map[int, pair[int, int]]* continuousMap,
+                     bool nps_param,
+                     bool verbose_param,
+                     bool predict,
+                     string error_plugin_path,
+                     size_t error_plugin_address,
+                     bool anytime,
+                     PySolutionWrapper solution_callback,
+                     bool solution_is_null,
+                     int *warm_tree,
+                     int warm_tree_size,
+                     vector[string]* depthResults,
+                     int maxLeaves,
+                     string checkpointPath,
+                     float checkpointInterval) except + nogil
+        void loadCheckpoint(const string &path) except +
+        string solveSharded(int nProcesses,
+                            int maxdepth,
+                            int minsup,
+                            bool infoGain,
+                            bool infoAsc,
+                            bool repeatSort,
+                            int timeLimit,
+                            float maxError) except + nogil
+        vector[TreeResult] crossValidate(const int *folds,
+                                         int nfolds,
+                                         int maxdepth,
+                                         int minsup,
+                                         bool infoGain,
+                                         bool infoAsc,
+                                         bool repeatSort,
+                                         int timeLimit,
+                                         int nThreads) except + nogil
+        vector[TreeResult] trainEnsemble(const int *samples,
+                                         const int *features,
+                                         int ntrees,
+                                         int maxdepth,
+                                         int minsup,
+                                         bool infoGain,
+                                         bool infoAsc,
+                                         bool repeatSort,
+                                         int timeLimit,
+                                         int nThreads,
+                                         CEnsemble *ensemble) except + nogil
+        vector[RankedTree] enumerateTrees(int maxTrees,
+                                          float epsilon,
+                                          bool pareto,
+                                          int maxLeaves,
+                                          int maxdepth,
+                                          int minsup,
+                                          int timeLimit,
+                                          int *latticeSize,
+                                          bool *timeout) except + nogil
+        vector[TreeResult] boost(int ntrees,
+                                 int maxdepth,
+                                 int minsup,
+                                 bool infoGain,
+                                 bool infoAsc,
+                                 bool repeatSort,
+                                 int timeLimit,
+                                 CEnsemble *ensemble) except + nogil
+        bool numaReplicas
+
+cdef extern from "src/headers/numa.h":
+    vector[vector[int]] numaNodes()
+
+cdef extern from "src/headers/arena.h":
+    bool hugePages "BitsetBlock::hugePages"
 
 cdef extern from "src/headers/py_error_function_wrapper.h":
     cdef cppclass PyErrorWrapper:
@@ -65,6 +181,442 @@ cdef extern from "src/headers/py_predictor_error_function_wrapper.h":
         PyPredictorErrorWrapper(object) # define a constructor that takes a Python object
              # note - doesn't match c++ signature - that's fine!
 
+cdef extern from "src/headers/py_solution_callback_wrapper.h":
+    cdef cppclass PySolutionWrapper:
+        PySolutionWrapper()
+        PySolutionWrapper(object) # define a constructor that takes a Python object
+             # note - doesn't match c++ signature - that's fine!
+
+
+# results by depth of the sweep running in each thread, which its call to solve fills
+_sweeps = threading.local()
+
+
+cdef class Solver:
+    """Searches on the same data, which keep its bitsets and the cache of the last search between the calls to solve.
+
+    The cache answers a search with the same depth, or with a larger minimum support when the last best tree still
+    satisfies it. A search with a larger depth and the same minimum support continues from the cache, each tree of
+    which bounds the search of its node. Otherwise, the search restarts warm started with the last best tree. Only the cache of the
+    misclassification error with the default search is kept, and only the best trees of the misclassification error
+    warm start the next searches. The calls to solve, sweep and load_checkpoint from several threads on the same
+    solver run one at a time, as they share the cache.
+    """
+    cdef CSolver *solver
+    cdef object supports, data, target, warm  # arrays read by the solver
+
+    def __cinit__(self, data, target, warm=None):
+        data = data.astype('int32')
+
+        ntransactions, nattributes = data.shape
+        classes, supports = np.unique(target, return_counts=True)
+        nclasses = len(classes)
+        supports = supports.astype('int32')
+
+        data = data.transpose()
+        # print(data)
+        if np.array_equal(data, data.astype('bool')) is False:  # WARNING: maybe categorical (not binary) inputs will be supported in the future
+            raise ValueError("Bad input type. DL8.5 actually only supports binary (0/1) inputs")
+        if not data.flags['C_CONTIGUOUS']:
+            data = np.ascontiguousarray(data) # Makes a contiguous copy of the numpy array.
+        cdef int [:, ::1] data_view = data
+        cdef int *data_matrix = &data_view[0][0]
+
+        cdef int [::1] target_view
+        cdef int *target_array = NULL
+        if target is not None:
+            target = target.astype('int32')
+            if not target.flags['C_CONTIGUOUS']:
+                target = np.ascontiguousarray(target) # Makes a contiguous copy of the numpy array.
+            target_view = target
+            target_array = &target_view[0]
+        else:
+            nclasses = 0
+
+        cdef int [::1] warm_view
+        cdef int *warm_array = NULL
+        if warm is not None:
+            warm = warm.astype('int32')
+            if not warm.flags['C_CONTIGUOUS']:
+                warm = np.ascontiguousarray(warm) # Makes a contiguous copy of the numpy array.
+            warm_view = warm
+            warm_array = &warm_view[0]
+
+        if not supports.flags['C_CONTIGUOUS']:
+            supports = np.ascontiguousarray(supports) # Makes a contiguous copy of the numpy array.
+        cdef int [::1] supports_view = supports
+
+        self.supports, self.data, self.target, self.warm = supports, data, target, warm
+        self.solver = new CSolver(&supports_view[0], ntransactions, nattributes, nclasses, data_matrix, target_array,
+                                  warm_array)
+
+    def __dealloc__(self):
+        del self.solver
+
+    def solve(self,
+              func=None,
+              fast_func=None,
+              predictor_func=None,
+              max_depth=1,
+              min_sup=1,
+              max_error=0,
+              stop_after_better=False,
+              iterative=False,
+              time_limit=0,
+              verb=False,
+              desc=False,
+              asc=False,
+              repeat_sort=False,
+              continuousMap=None,
+              nps=False,
+              predictor=False,
+              error_plugin=None,
+              anytime=False,
+              solution_callback=None,
+              warm_tree=None,
+              max_leaves=0,
+              checkpoint=None,
+              checkpoint_interval=0):
+        """Search a tree as the module solve, continuing from the cache of the last search when it answers this one.
+
+        When checkpoint is a path, the cache of the misclassification error with the default search is written there
+        every checkpoint_interval seconds, if positive, and when the search stops, the time limit included, so that
+        load_checkpoint lets another solver on the same data continue the search.
+        """
+        # wrappers of missing functions hold no Python object so that they can be copied without the GIL
+        cdef PyErrorWrapper f_user
+        cdef bool error_null_flag = True
+        if func is not None:
+            f_user = PyErrorWrapper(func)
+            error_null_flag = False
+
+        cdef PyFastErrorWrapper f_user_fast
+        cdef bool fast_error_null_flag = True
+        if fast_func is not None:
+            f_user_fast = PyFastErrorWrapper(fast_func)
+            fast_error_null_flag = False
+
+        cdef PyPredictorErrorWrapper f_user_predictor
+        if predictor_func is not None:
+            f_user_predictor = PyPredictorErrorWrapper(predictor_func)
+
+        cdef PySolutionWrapper f_solution
+        cdef bool solution_null_flag = True
+        if solution_callback is not None:
+            f_solution = PySolutionWrapper(solution_callback)
+            solution_null_flag = False
+
+        # the prior tree is given in preorder, as built by the predictors
+        cdef int [::1] warm_tree_view
+        cdef int *warm_tree_array = NULL
+        cdef int c_warm_tree_size = 0
+        if warm_tree is not None and len(warm_tree) > 0:
+            warm_tree = np.ascontiguousarray(warm_tree, dtype='int32')
+            warm_tree_view = warm_tree
+            warm_tree_array = &warm_tree_view[0]
+            c_warm_tree_size = len(warm_tree)
+
+        # max_err = max_error - 1  # because maxError but not be reached
+        if max_error < 0:  # raise error when incompatibility between max_error value and stop_after_better value
+            stop_after_better = False
+
+        cont_map = NULL
+        if continuousMap is not None:
+            #cont_map must be defined properly
+            cont_map = NULL
+
+        info_gain = not (desc == False and asc == False)
+
+        # a native error function is given either as the path of a shared library or as the address of a plugin
+        # structure
+        cdef string plugin_path = b""
+        cdef size_t plugin_address = 0
+        if error_plugin is not None:
+            if isinstance(error_plugin, int):
+                plugin_address = error_plugin
+            elif isinstance(error_plugin, ctypes.Structure):
+                plugin_address = ctypes.addressof(error_plugin)
+            else:
+                plugin_path = os.fsencode(error_plugin)
+
+        cdef int c_max_depth = max_depth, c_min_sup = min_sup, c_time_limit = time_limit
+        cdef float c_max_error = max_error
+        cdef bool c_stop_after_better = stop_after_better, c_iterative = iterative, c_info_gain = info_gain
+        cdef bool c_asc = asc, c_repeat_sort = repeat_sort, c_nps = nps, c_verb = verb
+        cdef bool c_predictor = predictor, c_anytime = anytime
+        cdef int c_max_leaves = max_leaves
+        cdef string c_checkpoint = b"" if checkpoint is None else os.fsencode(checkpoint)
+        cdef float c_checkpoint_interval = checkpoint_interval
+        cdef string out
+        # results by depth of the iterative search of a sweep of this thread, NULL otherwise
+        cdef vector[string] *depth_results = <vector[string] *> <size_t> getattr(_sweeps, "depth_results", 0)
+
+        # the search does not touch any Python object unless a Python function is given. In that case, the GIL is kept
+        # as the wrappers of these functions are copied by the search. Otherwise, it is released to let other threads
+        # run searches
+        if error_null_flag and fast_error_null_flag and predictor_func is None and solution_null_flag:
+            with nogil:
+                out = self.solver.solve(c_max_error, c_stop_after_better, c_iterative, f_user, f_user_fast,
+                                        f_user_predictor, error_null_flag, fast_error_null_flag, c_max_depth,
+                                        c_min_sup, c_info_gain, c_asc, c_repeat_sort, c_time_limit, NULL, c_nps,
+                                        c_verb, c_predictor, plugin_path, plugin_address, c_anytime, f_solution,
+                                        solution_null_flag, warm_tree_array, c_warm_tree_size,
+                                        depth_results, c_max_leaves, c_checkpoint,
+                                        c_checkpoint_interval)
+        else:
+            out = self.solver.solve(c_max_error, c_stop_after_better, c_iterative, f_user, f_user_fast,
+                                    f_user_predictor, error_null_flag, fast_error_null_flag, c_max_depth, c_min_sup,
+                                    c_info_gain, c_asc, c_repeat_sort, c_time_limit, NULL, c_nps, c_verb, c_predictor,
+                                    plugin_path, plugin_address, c_anytime, f_solution, solution_null_flag,
+                                    warm_tree_array, c_warm_tree_size, depth_results, c_max_leaves,
+                                    c_checkpoint, c_checkpoint_interval)
+
+        return out.decode("utf-8")
+
+    def load_checkpoint(self, path):
+        """Load the cache written by a search with a checkpoint on the same data. The next search with the same
+        max_depth and min_sup continues from it, warm started with its best tree. Raise RuntimeError when the
+        checkpoint is unreadable or was written for other data."""
+        self.solver.loadCheckpoint(os.fsencode(path))
+
+    def solve_sharded(self, n_processes=0, max_depth=1, min_sup=1, max_error=0, desc=False, asc=False,
+                      repeat_sort=False, time_limit=0):
+        """Search the best tree with the misclassification error in n_processes worker processes, one per core when
+        n_processes is not positive.
+
+        The attributes tested by the root are dealt to the workers, which share the best error of the root through
+        shared memory. Return the output of solve, with the total lattice size of the workers and the elapsed time.
+        """
+        cdef int c_n_processes = n_processes, c_max_depth = max_depth, c_min_sup = min_sup
+        cdef int c_time_limit = time_limit
+        cdef float c_max_error = max_error
+        cdef bool c_info_gain = not (desc == False and asc == False), c_asc = asc, c_repeat_sort = repeat_sort
+        cdef string out
+        with nogil:
+            out = self.solver.solveSharded(c_n_processes, c_max_depth, c_min_sup, c_info_gain, c_asc, c_repeat_sort,
+                                           c_time_limit, c_max_error)
+        return out.decode("utf-8")
+
+    def sweep(self, configurations, **kwargs):
+        """Search the optimal trees of several (max_depth, min_sup) configurations.
+
+        The configurations with the same minimum support share one iterative search up to their largest depth, whose
+        iterations give the trees of the smaller depths. The other parameters are those of solve, except max_error and
+        stop_after_better, which would only bound the last depth. Return the results of solve by configuration.
+        """
+        cdef vector[string] depth_results
+        results = {}
+        for min_sup in sorted({m for _, m in configurations}):
+            depths = [d for d, m in configurations if m == min_sup]
+            depth_results.clear()
+            _sweeps.depth_results = <size_t> &depth_results
+            try:
+                out = self.solve(max_depth=max(depths), min_sup=min_sup, iterative=True, **kwargs)
+            finally:
+                _sweeps.depth_results = 0
+            # the depths which the search did not complete, when it is stopped, get its last result
+            for depth in depths:
+                if depth <= depth_results.size():
+                    results[(depth, min_sup)] = depth_results[depth - 1].decode("utf-8")
+                else:
+                    results[(depth, min_sup)] = out
+        return results
+
+    def cross_validate(self, folds, max_depth=1, min_sup=1, desc=False, asc=False, repeat_sort=False, time_limit=0,
+                       n_jobs=0):
+        """Search a tree with the misclassification error on the transactions out of each fold.
+
+        folds gives the fold of each transaction, numbered from 0. The folds are searched in parallel by n_jobs
+        threads, one per core when n_jobs is not positive, without the GIL. The time limit applies to each fold.
+        Return for each fold a dict with the tree ("tree", None when there is no tree), its error on the training
+        transactions ("error"), the number of transactions of the fold it misclassifies ("validation_error"),
+        "lattice_size" and "timeout".
+        """
+        if self.target is None:
+            raise ValueError("The cross-validation needs the classes of the transactions")
+        folds = np.ascontiguousarray(folds, dtype='int32')
+        if folds.shape != self.target.shape:
+            raise ValueError("folds must give the fold of each transaction")
+        cdef int [::1] folds_view = folds
+        cdef int c_nfolds = folds.max() + 1, c_max_depth = max_depth, c_min_sup = min_sup
+        cdef bool c_info_gain = not (desc == False and asc == False), c_asc = asc, c_repeat_sort = repeat_sort
+        cdef int c_time_limit = time_limit, c_n_jobs = n_jobs
+        cdef vector[TreeResult] fold_results
+        with nogil:
+            fold_results = self.solver.crossValidate(&folds_view[0], c_nfolds, c_max_depth, c_min_sup, c_info_gain,
+                                                     c_asc, c_repeat_sort, c_time_limit, c_n_jobs)
+        return tree_results(fold_results)
+
+    def train_ensemble(self, n_estimators=10, bootstrap=True, max_features=None, random_state=None, max_depth=1,
+                       min_sup=1, desc=False, asc=False, repeat_sort=False, time_limit=0, n_jobs=0):
+        """Learn an ensemble of trees with the misclassification error, each on a sample of the transactions and a
+        subset of the attributes.
+
+        The sample of a tree is drawn with replacement when bootstrap is true, each transaction drawn being counted
+        once, and is all the transactions otherwise. max_features is the number of attributes of each tree, or their
+        fraction when it is a float, all of them when None. The trees are learnt in parallel as in cross_validate.
+        Return the Ensemble, whose results give for each tree the dict of cross_validate, the validation error being
+        on the transactions out of its sample.
+        """
+        if self.target is None:
+            raise ValueError("The ensembles need the classes of the transactions")
+        random = np.random.RandomState(random_state)
+        ntransactions, nattributes = len(self.target), self.data.shape[0]
+        samples = np.ones((n_estimators, ntransactions), dtype='int32')
+        if bootstrap:
+            samples[:] = 0
+            for i in range(n_estimators):
+                samples[i, random.randint(0, ntransactions, ntransactions)] = 1
+        features = None
+        if max_features is not None:
+            k = int(max_features * nattributes) if isinstance(max_features, float) else max_features
+            features = np.zeros((n_estimators, nattributes), dtype='int32')
+            for i in range(n_estimators):
+                features[i, random.choice(nattributes, min(max(k, 0), nattributes), replace=False)] = 1
+
+        ensemble = Ensemble()
+        (<Ensemble> ensemble).nattributes = nattributes
+        cdef int [:, ::1] samples_view = samples
+        cdef int [:, ::1] features_view
+        cdef int *features_array = NULL
+        if features is not None:
+            features_view = features
+            features_array = &features_view[0][0]
+        cdef int c_n_estimators = n_estimators, c_max_depth = max_depth, c_min_sup = min_sup
+        cdef bool c_info_gain = not (desc == False and asc == False), c_asc = asc, c_repeat_sort = repeat_sort
+        cdef int c_time_limit = time_limit, c_n_jobs = n_jobs
+        cdef vector[TreeResult] results
+        cdef CEnsemble *c_ensemble = (<Ensemble> ensemble).ensemble
+        with nogil:
+            results = self.solver.trainEnsemble(&samples_view[0][0], features_array, c_n_estimators, c_max_depth,
+                                                c_min_sup, c_info_gain, c_asc, c_repeat_sort, c_time_limit, c_n_jobs,
+                                                c_ensemble)
+        ensemble.results = tree_results(results)
+        return ensemble
+
+    def boost(self, n_estimators=10, max_depth=1, min_sup=1, desc=False, asc=False, repeat_sort=False, time_limit=0):
+        """Learn an ensemble of at most n_estimators trees by boosting (SAMME).
+
+        Each tree minimizes the misclassification error of the transactions weighted by the previous trees, the
+        transactions it misclassifies weighing more for the next ones. The boosting stops at a tree without error or
+        no better than chance. Return the Ensemble, whose results give for each tree the dict of cross_validate, the
+        error being weighted and the validation error being the number of transactions misclassified, with the
+        "weight" of its vote.
+        """
+        if self.target is None:
+            raise ValueError("The boosting needs the classes of the transactions")
+        ensemble = Ensemble()
+        (<Ensemble> ensemble).nattributes = self.data.shape[0]
+        cdef int c_n_estimators = n_estimators, c_max_depth = max_depth, c_min_sup = min_sup
+        cdef bool c_info_gain = not (desc == False and asc == False), c_asc = asc, c_repeat_sort = repeat_sort
+        cdef int c_time_limit = time_limit
+        cdef vector[TreeResult] results
+        cdef CEnsemble *c_ensemble = (<Ensemble> ensemble).ensemble
+        with nogil:
+            results = self.solver.boost(c_n_estimators, c_max_depth, c_min_sup, c_info_gain, c_asc, c_repeat_sort,
+                                        c_time_limit, c_ensemble)
+        ensemble.results = tree_results(results)
+        for result, weight in zip(ensemble.results, c_ensemble.weights):
+            result["weight"] = weight
+        return ensemble
+
+    def best_trees(self, k=10, epsilon=None, max_depth=1, min_sup=1, time_limit=0):
+        """Search the k best trees with the misclassification error, or the Rashomon set of the trees whose error is
+        within epsilon of the best one, of at most k trees.
+
+        The trees of the same error go by their size, and a test is only kept when it is better than a leaf. The
+        whole lattice up to the maximum depth is explored, each node keeping at most k subtrees. Return a dict with
+        the "trees", the best first, each a dict with the "tree", its "error", "size" and "depth", and the
+        "lattice_size" and "timeout" of the search.
+        """
+        return self.enumerate_trees(k, FLT_MAX if epsilon is None else epsilon, False, 0, max_depth, min_sup,
+                                    time_limit)
+
+    def pareto_front(self, max_depth=1, min_sup=1, max_leaves=0, time_limit=0):
+        """Search the Pareto front of the misclassification error and the size of the trees: the trees for which no
+        other tree is as good on both and better on one.
+
+        Each node of the search keeps the front of its subtrees. The trees have at most max_leaves leaves when it is
+        positive. Return a dict as best_trees, whose trees go from the best error to the smallest tree.
+        """
+        return self.enumerate_trees(0, FLT_MAX, True, max_leaves, max_depth, min_sup, time_limit)
+
+    cdef enumerate_trees(self, int k, float epsilon, bool pareto, int max_leaves, int max_depth, int min_sup,
+                         int time_limit):
+        if self.target is None:
+            raise ValueError("The enumeration needs the classes of the transactions")
+        cdef int lattice_size = 0
+        cdef bool timeout = False
+        cdef vector[RankedTree] trees
+        with nogil:
+            trees = self.solver.enumerateTrees(k, epsilon, pareto, max_leaves, max_depth, min_sup, time_limit,
+                                               &lattice_size, &timeout)
+        return {"trees": [{"tree": json.loads(tree.tree.decode("utf-8")), "error": tree.error, "size": tree.size,
+                           "depth": tree.depth} for tree in trees],
+                "lattice_size": lattice_size,
+                "timeout": timeout}
+
+    @property
+    def numa_replicas(self):
+        """Whether cross_validate and train_ensemble read a replica of the data on the NUMA node of each thread, on a
+        host of several nodes, the threads being pinned to their node. Otherwise, they all read the same data."""
+        return self.solver.numaReplicas
+
+    @numa_replicas.setter
+    def numa_replicas(self, value):
+        self.solver.numaReplicas = value
+
+
+def numa_nodes():
+    """Return the cpus of each NUMA node of the host, a single node without cpus when the topology is unknown."""
+    return numaNodes()
+
+
+def set_huge_pages(enabled):
+    """Set whether the bitsets of the data and of the covers allocated afterwards ask for huge pages, as by default.
+
+    The bitsets of a huge page or more are then backed by the huge pages reserved for the applications, or by
+    transparent huge pages, where the system gives them.
+    """
+    global hugePages
+    hugePages = enabled
+
+
+cdef tree_results(vector[TreeResult] &results):
+    return [{"tree": json.loads(result.tree.decode("utf-8")) if result.validationError >= 0 else None,
+             "error": result.error if result.validationError >= 0 else None,
+             "validation_error": result.validationError if result.validationError >= 0 else None,
+             "lattice_size": result.latticeSize,
+             "timeout": result.timeout} for result in results]
+
+
+cdef class Ensemble:
+    """Trees voting for the class of the transactions, learnt by Solver.train_ensemble or Solver.boost."""
+    cdef CEnsemble *ensemble
+    cdef int nattributes  # of the data of the trees
+    cdef public object results  # result of the search of each tree
+
+    def __cinit__(self):
+        self.ensemble = new CEnsemble()
+
+    def __dealloc__(self):
+        del self.ensemble
+
+    def predict(self, X):
+        """Class of each row of the binary matrix X voted by the trees with their weights, the ties going to the first
+        class."""
+        X = np.ascontiguousarray(X, dtype='int32')
+        if X.ndim != 2 or X.shape[1] != self.nattributes:
+            raise ValueError("X must have the attributes of the data of the trees")
+        predictions = np.zeros(X.shape[0], dtype='int32')
+        if X.shape[0] == 0:
+            return predictions
+        cdef int [:, ::1] data_view = X
+        cdef int [::1] predictions_view = predictions
+        cdef int ntransactions = X.shape[0], nattributes = X.shape[1]
+        with nogil:
+            self.ensemble.predict(&data_view[0][0], ntransactions, nattributes, &predictions_view[0])
+        return predictions
 
 def solve(data,
           target,
@@ -85,98 +637,13 @@ def solve(data,
           continuousMap=None,
           bin_save=False,
           nps=False,
-          predictor=False):
-
-    cdef PyErrorWrapper f_user = PyErrorWrapper(func)
-    error_null_flag = True
-    if func is not None:
-        error_null_flag = False
-
-    cdef PyFastErrorWrapper f_user_fast = PyFastErrorWrapper(fast_func)
-    fast_error_null_flag = True
-    if fast_func is not None:
-        fast_error_null_flag = False
-
-    cdef PyPredictorErrorWrapper f_user_predictor = PyPredictorErrorWrapper(predictor_func)
-
-    data = data.astype('int32')
-
-
-    ntransactions, nattributes = data.shape
-    classes, supports = np.unique(target, return_counts=True)
-    nclasses = len(classes)
-    supports = supports.astype('int32')
-
-
-    data = data.transpose()
-    # print(data)
-    if np.array_equal(data, data.astype('bool')) is False:  # WARNING: maybe categorical (not binary) inputs will be supported in the future
-        raise ValueError("Bad input type. DL8.5 actually only supports binary (0/1) inputs")
-    if not data.flags['C_CONTIGUOUS']:
-        data = np.ascontiguousarray(data) # Makes a contiguous copy of the numpy array.
-    cdef int [:, ::1] data_view = data
-    cdef int *data_matrix = &data_view[0][0]
-
-    cdef int [::1] target_view
-    cdef int *target_array = NULL
-    if target is not None:
-        target = target.astype('int32')
-        if not target.flags['C_CONTIGUOUS']:
-            target = np.ascontiguousarray(target) # Makes a contiguous copy of the numpy array.
-        target_view = target
-        target_array = &target_view[0]
-    else:
-        nclasses = 0
-   
-    cdef int [::1] warm_view
-    cdef int *warm_array = NULL
-    if warm is not None:
-        warm = warm.astype('int32')
-        if not warm.flags['C_CONTIGUOUS']:
-            warm = np.ascontiguousarray(warm) # Makes a contiguous copy of the numpy array.
-        warm_view = warm
-        warm_array = &warm_view[0]
-
-    if not supports.flags['C_CONTIGUOUS']:
-        supports = np.ascontiguousarray(supports) # Makes a contiguous copy of the numpy array.
-    cdef int [::1] supports_view = supports
-
-    # max_err = max_error - 1  # because maxError but not be reached
-    if max_error < 0:  # raise error when incompatibility between max_error value and stop_after_better value
-        stop_after_better = False
-
-    cont_map = NULL
-    if continuousMap is not None:
-        #cont_map must be defined properly
-        cont_map = NULL
-
-    info_gain = not (desc == False and asc == False)
-
-    out = search(&supports_view[0],
-                 ntransactions,
-                 nattributes,
-                 nclasses,
-                 data_matrix,
-                 target_array,
-                 warm_array,
-                 max_error,
-                 stop_after_better,
-                 iterative,
-                 error_callback = f_user,
-                 fast_error_callback = f_user_fast,
-                 predictor_error_callback = f_user_predictor,
-                 error_is_null = error_null_flag,
-                 fast_error_is_null = fast_error_null_flag,
-                 maxdepth = max_depth,
-                 minsup = min_sup,
-                 infoGain = info_gain,
-                 infoAsc = asc,
-                 repeatSort = repeat_sort,
-                 timeLimit = time_limit,
-                 continuousMap = NULL,
-                 save = bin_save,
-                 nps_param = nps,
-                 verbose_param = verb,
-                 predict = predictor)
-
-    return out.decode("utf-8")
\ No newline at end of file
+          predictor=False,
+          error_plugin=None,
+          anytime=False,
+          solution_callback=None,
+          warm_tree=None,
+          max_leaves=0):
+    return Solver(data, target, warm).solve(func, fast_func, predictor_func, max_depth, min_sup, max_error,
+                                            stop_after_better, iterative, time_limit, verb, desc, asc, repeat_sort,
+                                            continuousMap, nps, predictor, error_plugin, anytime, solution_callback,
+                                            warm_tree, max_leaves)
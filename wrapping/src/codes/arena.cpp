@@ -0,0 +1,107 @@
+#include "arena.h"
+#include <cstring>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#define BITSET_ALIGNMENT 64
+#define HUGE_PAGE_SIZE ((size_t) 2 << 20)
+
+Arena::Arena(size_t blockSize): blockSize(blockSize) {
+}
+
+Arena::~Arena() {
+    for (char* block : blocks)
+        delete[] block;
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    size_t padding = (alignment - ((size_t) current % alignment)) % alignment;
+    if (current == nullptr || padding + size > remaining) {
+        // requests larger than a block get their own block
+        size_t newSize = max(blockSize, size + alignment);
+        current = new char[newSize];
+        blocks.push_back(current);
+        remaining = newSize;
+        padding = (alignment - ((size_t) current % alignment)) % alignment;
+    }
+    void* result = current + padding;
+    current += padding + size;
+    remaining -= padding + size;
+    return result;
+}
+
+atomic<bool> BitsetBlock::hugePages(true);
+
+BitsetBlock::BitsetBlock(size_t size) {
+    size = max(size, (size_t) 1);
+#if defined(__linux__)
+    if (hugePages && size >= HUGE_PAGE_SIZE) {
+        size_t length = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+#if defined(MAP_HUGETLB)
+        // fails unless huge pages are reserved for the applications
+        void* block = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (block != MAP_FAILED) {
+            memory = base = (char*) block;
+            mapped = length;
+            pages = RESERVED_HUGE_PAGES;
+            return;
+        }
+#endif
+        // a transparent huge page must start on a boundary of huge pages, hence the extra page to align the block
+        void* mapping = mmap(nullptr, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping != MAP_FAILED) {
+            base = (char*) mapping;
+            mapped = length + HUGE_PAGE_SIZE;
+            memory = base + (HUGE_PAGE_SIZE - (size_t) base % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+#if defined(MADV_HUGEPAGE)
+            if (madvise(memory, length, MADV_HUGEPAGE) == 0)
+                pages = TRANSPARENT_HUGE_PAGES;
+#endif
+            return;
+        }
+    }
+#endif
+    base = new char[size + BITSET_ALIGNMENT - 1];
+    memory = base + (BITSET_ALIGNMENT - (size_t) base % BITSET_ALIGNMENT) % BITSET_ALIGNMENT;
+    memset(memory, 0, size);
+}
+
+BitsetBlock::~BitsetBlock() {
+#if defined(__linux__)
+    if (mapped > 0) {
+        munmap(base, mapped);
+        return;
+    }
+#endif
+    delete[] base;
+}
+
+SearchBuffers::SearchBuffers(Depth maxDepth, Attribute nattributes, Class nclasses): maxDepth(maxDepth), nattributes(nattributes) {
+    // a node at depth d has d items and there are as many depths as items in the deepest itemset, plus the root
+    itemsets = new Item[(maxDepth + 1) * max(maxDepth, 1)];
+    succs = new pair<bool, Attribute>[(maxDepth + 1) * max(nattributes, 1)];
+    supports[0] = zeroSupports(nclasses);
+    supports[1] = zeroSupports(nclasses);
+    gains.reserve(nattributes);
+}
+
+SearchBuffers::~SearchBuffers() {
+    delete[] itemsets;
+    delete[] succs;
+    deleteSupports(supports[0]);
+    deleteSupports(supports[1]);
+}
+
+void SearchBuffers::sortByGain(Array<pair<bool, Attribute>>& successors, bool ascending) {
+    sort(gains.begin(), gains.end(), [](const pair<pair<float, int>, pair<bool, Attribute>>& a,
+                                        const pair<pair<float, int>, pair<bool, Attribute>>& b) {
+        return a.first < b.first;
+    });
+    if (ascending)
+        for (auto it = gains.begin(); it != gains.end(); ++it)
+            successors.push_back(it->second);
+    else
+        for (auto it = gains.rbegin(); it != gains.rend(); ++it)
+            successors.push_back(it->second);
+}
@@ -73,8 +73,6 @@ void DataBinary::read ( const char *filename ) {
   --ntransactions;
   fclose ( in );
   
-  ::nattributes = nattributes;
-  ::nclasses = nclasses;
   
   // Now we allocate the matrix with data
   b = new Bool*[ntransactions];
@@ -82,7 +80,7 @@ void DataBinary::read ( const char *filename ) {
   // data is close to each other in memory
   b[0] = new Bool[ntransactions * nattributes]; 
   c = new Class[ntransactions];
-  supports = zeroSupports();
+  supports = zeroSupports(nclasses);
   
   in = fopen ( filename, "rt" );
   for ( int i = 0; i < ntransactions; ++i ) {
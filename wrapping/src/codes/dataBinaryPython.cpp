@@ -18,9 +18,6 @@ DataBinaryPython::DataBinaryPython(Supports supportss, Transaction numtransactio
     ntransactions = numtransactions;
     nattributes = numattributes;
     supports = supportss;
-
-    ::nattributes = nattributes;
-    ::nclasses = nclasses;
 }
 
 
@@ -101,9 +101,8 @@ void DataContinuous::read ( const char *filename ) {
   ntransactions = data[0].size();
   //int nContattributes = data.size();
   nclasses = *max_element(c.begin(),c.end()) + 1;
-  ::nclasses = nclasses;
 
-  supports = zeroSupports();
+  supports = zeroSupports(nclasses);
 
   fin.close();
 
@@ -262,7 +261,6 @@ void DataContinuous::binarize(vector<vector<float>> toBinarize) {
   }
   b = transpose(b);
   nattributes = int(b[0].size());
-  ::nattributes = nattributes;
 
   /*nFeatures_after = b[0].size();
   nFeatures_added = nFeatures_after - nFeatures_before;
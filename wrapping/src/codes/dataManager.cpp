@@ -9,12 +9,10 @@
 
 DataManager::DataManager(int* supports, int ntransactions, int nattributes, int nclasses, int *data, int *target, int *warm):supports(supports), ntransactions(ntransactions), nattributes(nattributes), nclasses(nclasses) {
     nWords = (int)ceil((float)ntransactions/M);
-    b = new bitset<M> *[nattributes];
-    c = new bitset<M> *[nclasses];
-    w = new bitset<M> *[1];
+    allocateColumns(target != nullptr, warm != nullptr);
 
     for (int i = 0; i < nattributes; i++){
-        bitset<M> * attrCov = new bitset<M>[nWords];
+        bitset<M> * attrCov = b[i];
         for (int j = 0; j < nWords; ++j) {
             int currentindex = -1;
             int* start = data + (ntransactions*i) + (M*j);
@@ -34,14 +32,13 @@ DataManager::DataManager(int* supports, int ntransactions, int nattributes, int
                 itr = find(start, end, 1);
             }
         }
-        b[i] = attrCov;
         //cout << "attr : " << i << " word = " << attrCov->to_string() << endl;
     }
 
 
     if (target){
         for (int i = 0; i < nclasses; i++){
-            bitset<M> * classCov = new bitset<M>[nWords];
+            bitset<M> * classCov = c[i];
             for (int j = 0; j < nWords; ++j) {
                 int currentindex = -1;
                 int* start = target + (M*j);
@@ -61,14 +58,11 @@ DataManager::DataManager(int* supports, int ntransactions, int nattributes, int
                     itr = find(start, end, i);
                 }
             }
-            c[i] = classCov;
         }
     }
-    else
-        c = nullptr;
 
     if (warm){
-        bitset<M> * classCov = new bitset<M>[nWords];
+        bitset<M> * classCov = w[0];
         for (int j = 0; j < nWords; ++j) {
             int currentindex = -1;
             int* start = warm + (M*j);
@@ -88,13 +82,31 @@ DataManager::DataManager(int* supports, int ntransactions, int nattributes, int
                 itr = find(start, end, 1);
             }
         }
-        w[0] = classCov;
     }
-    else
-        w = nullptr;
+}
+
+void DataManager::allocateColumns(bool target, bool warm) {
+    // each column starts on a cache line
+    stride = (nWords + 7) / 8 * 8;
+    int ncolumns = nattributes + (target ? nclasses : 0) + (warm ? 1 : 0);
+    block = new BitsetBlock((size_t) ncolumns * stride * sizeof(bitset<M>));
+    bitset<M> *column = (bitset<M> *) block->data();
+    b = new bitset<M> *[nattributes];
+    for (int i = 0; i < nattributes; ++i, column += stride)
+        b[i] = column;
+    c = target ? new bitset<M> *[nclasses] : nullptr;
+    for (int i = 0; target && i < nclasses; ++i, column += stride)
+        c[i] = column;
+    w = warm ? new bitset<M> *[1] : nullptr;
+    if (warm)
+        w[0] = column;
+}
 
-    ::nattributes = nattributes;
-    ::nclasses = nclasses;
+DataManager::DataManager(const DataManager &other): nWords(other.nWords), attrFeat(other.attrFeat), ntransactions(other.ntransactions), nattributes(other.nattributes), nclasses(other.nclasses), supports(other.supports) {
+    allocateColumns(other.c != nullptr, other.w != nullptr);
+    // the columns follow each other in the block
+    int ncolumns = nattributes + (c != nullptr ? nclasses : 0) + (w != nullptr ? 1 : 0);
+    copy_n((bitset<M> *) other.block->data(), (size_t) ncolumns * stride, (bitset<M> *) block->data());
 }
 
 bitset<M>* DataManager::getAttributeCover(int attr) {
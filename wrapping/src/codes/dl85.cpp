@@ -12,46 +12,421 @@
 #include "dataBinary.h"
 #include "dataBinaryPython.h"
 #include "lcm_pruned.h"
+#include "lcm_enumeration.h"
 #include "query_totalfreq.h"
 #include "experror.h"
 #include "dataManager.h"
+#include "plugin_error_function.h"
+#include "logger.h"
+#include "numa.h"
+#include "dl85.h"
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <fstream>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
 
 //using namespace std;
 
-bool nps = false;
-bool verbose = false;
+thread_local bool Logger::enable = false;
 
-string search(//std::function<float(Array<int>::iterator)> callback,
-              Supports supports,
-              Transaction ntransactions,
-              Attribute nattributes,
-              Class nclasses,
-              Bool *data,
-              Class *target,
-              Class *warm,
-              float maxError,
-              bool stopAfterError,
-              bool iterative,
-              function<vector<float>(RCover*)> error_callback,
-              function<vector<float>(RCover*)> fast_error_callback,
-              function<float(RCover*)> predictor_error_callback,
-              bool error_is_null,
-              bool fast_error_is_null,
-              int maxdepth,
-              int minsup,
-              bool infoGain,
-              bool infoAsc,
-              bool repeatSort,
-              int timeLimit,
-              map<int, pair<int, int>> *continuousMap,
-              bool save,
-              bool nps_param,
-              bool verbose_param,
-              bool predict) {
+struct SearchParameters {
+    DataManager *dataReader;
+    ExpError *experror;
+    ErrorPlugin *error_plugin;
+    function<vector<float>(RCover*)> *error_callback;
+    function<vector<float>(RCover*)> *fast_error_callback;
+    function<float(RCover*)> *predictor_error_callback;
+    function<bool(string, float, float, float)> *solution_callback;
+    float maxError;
+    bool stopAfterError;
+    bool iterative;
+    int maxdepth;
+    int minsup;
+    bool infoGain;
+    bool infoAsc;
+    bool repeatSort;
+    int timeLimit;
+    bool continuous;
+    bool nps;
+    int *warmTree;
+    int warmTreeSize;
+    vector<string> *depthResults;
+    const float *weights; // weights of the transactions for the weighted misclassification error
+    // called to write the cache with the nodes whose solutions are not final, nullptr without checkpoints
+    function<void(const vector<Node>&)> *checkpoint;
+    float checkpointInterval; // seconds between two checkpoints, 0 to write them only when the search stops
+};
 
-    std::cout << "TESTING STUFF" << std::endl;
+// steps of the search between two checks of the time of the checkpoints
+#define CHECKPOINT_STEPS 10000
+
+template<class Query_>
+void runSteps(LcmIterative<Query_> &lcm, Query_ * /*query*/, const SearchParameters & /*p*/) {
+    lcm.run();
+}
+
+// run the search, writing the cache every checkpointInterval seconds and when the search stops. The time limit is then
+// checked between the steps of the search, so that the cache is written before the nodes of the current branch are
+// closed with the trees found so far
+template<class Query_>
+void runSteps(LcmPruned<Query_> &lcm, Query_ *query, const SearchParameters &p) {
+    if (p.checkpoint == nullptr) {
+        lcm.run();
+        return;
+    }
+    int timeLimit = query->timeLimit;
+    query->timeLimit = 0;
+    lcm.start();
+    float lastCheckpoint = 0;
+    bool complete;
+    while (!(complete = lcm.resume(CHECKPOINT_STEPS))) {
+        bool timeout = timeLimit > 0 && query->runTime() >= timeLimit;
+        if (timeout || (p.checkpointInterval > 0 && query->runTime() - lastCheckpoint >= p.checkpointInterval)) {
+            (*p.checkpoint)(lcm.pendingNodes());
+            lastCheckpoint = query->runTime();
+        }
+        if (timeout) {
+            query->timeLimitReached = true;
+            lcm.resume();
+            break;
+        }
+    }
+    query->timeLimit = timeLimit;
+    if (complete) { // the search stopped at the root by the solution callback or maxError leaves its tree unproven
+        vector<Node> pending;
+        if (query->timeLimitReached || query->stopAfterError)
+            pending.push_back(query->realroot);
+        (*p.checkpoint)(pending);
+    }
+}
 
-    clock_t t = clock();
+template<class Engine, class Query_>
+string runEngine(Query_ *query, const SearchParameters &p) {
+    Engine lcm(p.dataReader, query, query->trie, p.infoGain, p.infoAsc, p.repeatSort);
+    runSteps(lcm, query, p);
+    string out = query->printResult(p.dataReader);
+    out += "LatticeSize: " + std::to_string(lcm.latticesize) + "\n";
+    return out;
+}
+
+// best tree below the node in preorder, as the prior trees: the test of each node then its positive and negative
+// subtrees, -1 for a leaf
+template<class E>
+void saveTree(Trie<E> *trie, Node node, vector<int> &tree) {
+    if (trie->left(node) == NO_NODE) {
+        tree.push_back(-1);
+        return;
+    }
+    tree.push_back(trie->test(node));
+    saveTree(trie, trie->right(node), tree);
+    saveTree(trie, trie->left(node), tree);
+}
+
+// run the search with the query, the cache and the engines instantiated for the error function. complete tells
+// whether the search went to the end, so that the solutions of the cache are optimal, and bestTree receives the tree
+// found
+template<class ErrorFunction>
+string runSearch(const SearchParameters &p, Trie<typename ErrorFunction::Error> *trie, bool &complete, vector<int> &bestTree) {
+    Query_TotalFreq<ErrorFunction> *query;
+    if (p.maxError <= 0)
+        query = new Query_TotalFreq<ErrorFunction>(trie, p.dataReader, p.experror, p.timeLimit, p.continuous, p.error_callback, p.fast_error_callback, p.predictor_error_callback);
+    else
+        query = new Query_TotalFreq<ErrorFunction>(trie, p.dataReader, p.experror, p.timeLimit, p.continuous, p.error_callback, p.fast_error_callback, p.predictor_error_callback, p.maxError, p.stopAfterError);
+
+    query->maxdepth = p.maxdepth;
+    query->minsup = p.minsup;
+    query->nps = p.nps;
+    query->error_plugin = p.error_plugin;
+    query->solution_callback = p.solution_callback;
+    query->warmTree.assign(p.warmTree, p.warmTree + p.warmTreeSize);
+    query->depthResults = p.depthResults;
+
+    string out;
+    if (p.iterative)
+        out = runEngine<LcmIterative<Query_TotalFreq<ErrorFunction>>>(query, p);
+    else
+        out = runEngine<LcmPruned<Query_TotalFreq<ErrorFunction>>>(query, p);
+    // the search stopped after a tree better than maxError leaves the root with a solution which is not optimal
+    complete = !query->timeLimitReached && !p.stopAfterError;
+    bestTree.clear();
+    if (trie->error(query->realroot) < noError<typename ErrorFunction::Error>())
+        saveTree(trie, query->realroot, bestTree);
+    delete query;
+    return out;
+}
+
+Solver::Solver(Supports supports, Transaction ntransactions, Attribute nattributes, Class nclasses, Bool *data, Class *target, Class *warm) {
+    dataReader = new DataManager(supports, ntransactions, nattributes, nclasses, data, target, warm);
+    //create error object and initialize it in the next
+    experror = new ExpError_Zero;
+}
+
+Solver::~Solver() {
+    delete trie;
+    for (DataManager *replica : replicas)
+        delete replica;
+    delete dataReader;
+    delete experror;
+}
+
+bool Solver::frequentTree(RCover *cover, Node node, int minsup) {
+    if (trie->left(node) == NO_NODE)
+        return cover->getSupport() >= minsup;
+    bool frequent = true;
+    for (int value = 0; value < 2 && frequent; ++value) {
+        cover->intersect(trie->test(node), value);
+        frequent = frequentTree(cover, value ? trie->right(node) : trie->left(node), minsup);
+        cover->backtrack();
+    }
+    return frequent;
+}
+
+void Solver::prepareCache(int maxdepth, int minsup, float maxError) {
+    // a solution is optimal for the depth of its search, and still a tree of a larger depth: the search of a larger
+    // depth with the same minimum support searches the nodes again with their trees as bounds
+    if (trie != nullptr && trieComplete && maxdepth > trieMaxdepth && minsup == trieMinsup) {
+        trieMaxdepth = maxdepth;
+        return;
+    }
+    // a larger minimum support only removes trees, so the best tree stays optimal as long as it is frequent enough.
+    // The solutions worse than maxError must not be returned
+    bool reuse = trie != nullptr && trieComplete && maxdepth == trieMaxdepth && minsup >= trieMinsup;
+    if (reuse && trie->error(trie->root) < noError<CountError>()) {
+        if (maxError > 0 && trie->error(trie->root) >= toError<CountError>(maxError))
+            reuse = false;
+        else if (minsup > trieMinsup) {
+            RCover cover(dataReader);
+            reuse = frequentTree(&cover, trie->root, minsup);
+        }
+    }
+    else if (reuse && minsup > trieMinsup) // without the best tree, the solutions of the other nodes may not be frequent
+        reuse = false;
+    if (!reuse) {
+        delete trie;
+        trie = new Trie<CountError>;
+    }
+    trieMaxdepth = maxdepth;
+    trieMinsup = minsup;
+}
+
+// hash of the data (FNV-1a), which tells whether a checkpoint was written for them
+uint64_t fingerprint(DataManager *dataReader) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&](uint64_t value) {
+        for (int byte = 0; byte < 8; ++byte) {
+            hash ^= (value >> (8 * byte)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    add(dataReader->getNTransactions());
+    add(dataReader->getNAttributes());
+    add(dataReader->getNClasses());
+    for (int i = 0; i < dataReader->nWords; ++i) {
+        for (Attribute attribute = 0; attribute < dataReader->getNAttributes(); ++attribute)
+            add(dataReader->getAttributeCover(attribute)[i].to_ullong());
+        forEachClass(c, dataReader->getNClasses())
+            add(dataReader->getClassCover(c)[i].to_ullong());
+    }
+    return hash;
+}
+
+// the checkpoint starts with its magic, its version and the fingerprint of the data, followed by the depth and the
+// minimum support of the search, the best tree of the root and the nodes of the cache. A node is its id, its itemset
+// and its fields, the children of its solution being given by their ids. All the values are 32-bit integers
+static const char CHECKPOINT_MAGIC[8] = {'D', 'L', '8', '5', 'C', 'K', 'P', 'T'};
+#define CHECKPOINT_VERSION 1
+
+void Solver::writeCheckpoint(const string &path, const vector<Node> &pending) {
+    vector<int> buffer;
+    buffer.push_back(trieMaxdepth);
+    buffer.push_back(trieMinsup);
+    vector<int> bestTree;
+    if (trie->error(trie->root) < noError<CountError>())
+        saveTree(trie, trie->root, bestTree);
+    buffer.push_back((int) bestTree.size());
+    buffer.insert(buffer.end(), bestTree.begin(), bestTree.end());
+
+    // the nodes of the current branch are left out, so that they are searched again
+    vector<bool> skipped(trie->getNNodes(), false);
+    for (Node node : pending)
+        skipped[node] = true;
+    size_t countPos = buffer.size();
+    buffer.push_back(0);
+    vector<Item> itemset;
+    function<void(Node)> visit = [&](Node node) {
+        if (trie->hasData(node) && !skipped[node]) {
+            ++buffer[countPos];
+            buffer.push_back(node);
+            buffer.push_back((int) itemset.size());
+            buffer.insert(buffer.end(), itemset.begin(), itemset.end());
+            int fields[] = {trie->test(node), static_cast<int>(trie->left(node)),
+                            static_cast<int>(trie->right(node)), trie->leafError(node),
+                            trie->error(node), trie->initUb(node), trie->lowerBound(node), trie->size(node),
+                            trie->solutionDepth(node)};
+            buffer.insert(buffer.end(), fields, fields + 9);
+        }
+        const TrieEdges &edges = trie->edges(node);
+        for (uint32_t i = 0; i < edges.size; ++i) {
+            itemset.push_back(edges.elts[i].item);
+            visit(edges.elts[i].subtrie);
+            itemset.pop_back();
+        }
+    };
+    visit(trie->root);
+
+    // the checkpoint replaces the last one only once written, so that a search killed meanwhile leaves it whole
+    string temporary = path + ".tmp";
+    ofstream out(temporary, ios::binary | ios::trunc);
+    int version = CHECKPOINT_VERSION;
+    uint64_t hash = fingerprint(dataReader);
+    out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    out.write((const char*) &version, sizeof(version));
+    out.write((const char*) &hash, sizeof(hash));
+    out.write((const char*) buffer.data(), buffer.size() * sizeof(int));
+    out.close();
+    if (!out || rename(temporary.c_str(), path.c_str()) != 0)
+        throw runtime_error("cache checkpoint: cannot write " + path);
+}
+
+void Solver::loadCheckpoint(const string &path) {
+    lock_guard<mutex> lock(cacheMutex);
+    ifstream in(path, ios::binary);
+    if (!in)
+        throw runtime_error("cache checkpoint: cannot open " + path);
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    int version = 0;
+    uint64_t hash = 0;
+    in.read(magic, sizeof(magic));
+    in.read((char*) &version, sizeof(version));
+    in.read((char*) &hash, sizeof(hash));
+    if (!in || !equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC) || version != CHECKPOINT_VERSION)
+        throw runtime_error("cache checkpoint: " + path + " is not a checkpoint of this version");
+    if (hash != fingerprint(dataReader))
+        throw runtime_error("cache checkpoint: " + path + " was written for other data");
+    auto next = [&]() {
+        int value;
+        if (!in.read((char*) &value, sizeof(value)))
+            throw runtime_error("cache checkpoint: " + path + " is truncated");
+        return value;
+    };
+
+    Trie<CountError> *cache = new Trie<CountError>;
+    try {
+        int maxdepth = next(), minsup = next();
+        vector<int> bestTree(next());
+        for (int &value : bestTree)
+            value = next();
+        map<int, Node> nodes; // node of each id of the checkpoint
+        vector<Node> tests;
+        for (int n = next(); n > 0; --n) {
+            int id = next();
+            vector<Item> itemset(next());
+            for (Item &item : itemset)
+                item = next();
+            Node node = cache->insert(Array<Item>(itemset.data(), (int) itemset.size()));
+            nodes[id] = node;
+            cache->setHasData(node);
+            cache->test(node) = next();
+            cache->left(node) = next();
+            cache->right(node) = next();
+            cache->leafError(node) = next();
+            cache->error(node) = next();
+            cache->initUb(node) = next();
+            cache->lowerBound(node) = next();
+            cache->size(node) = next();
+            cache->setSolutionDepth(node, next());
+            if (cache->left(node) != NO_NODE)
+                tests.push_back(node);
+        }
+        for (Node node : tests) {
+            if (!nodes.count(cache->left(node)) || !nodes.count(cache->right(node)))
+                throw runtime_error("cache checkpoint: " + path + " is corrupted");
+            cache->left(node) = nodes[cache->left(node)];
+            cache->right(node) = nodes[cache->right(node)];
+        }
+        // the solutions of the checkpoint are optimal, as the nodes being searched are left out
+        delete trie;
+        trie = cache;
+        trieMaxdepth = maxdepth;
+        trieMinsup = minsup;
+        trieComplete = true;
+        lastTree.swap(bestTree);
+    } catch (...) {
+        if (trie != cache)
+            delete cache;
+        throw;
+    }
+}
+
+// search the best tree of at most maxLeaves leaves with the misclassification error: the first one of the Pareto front
+// of the error and the number of leaves. The tree is written in the cache as by the search of the best tree, so that
+// it is printed the same way. bestTree receives it
+string runLeafBudgetSearch(const SearchParameters &p, int maxLeaves, vector<int> &bestTree) {
+    Trie<CountError> cache;
+    Query_TotalFreq<MisclassificationError> query(&cache, p.dataReader, p.experror, p.timeLimit, false);
+    query.maxdepth = p.maxdepth;
+    query.minsup = p.minsup;
+    LcmEnumeration<Query_TotalFreq<MisclassificationError>> lcm(p.dataReader, &query, &cache, 0, NO_ERR, true,
+                                                                maxLeaves);
+    lcm.run();
+    lcm.saveSolution(lcm.root, 0);
+    if (p.maxError > 0 && cache.error(lcm.root) >= toError<CountError>(p.maxError)) { // no tree better than the bound
+        cache.error(lcm.root) = noError<CountError>();
+        cache.left(lcm.root) = cache.right(lcm.root) = NO_NODE;
+        cache.size(lcm.root) = 1;
+    }
+    else
+        saveTree(&cache, lcm.root, bestTree);
+
+    string out = query.printResult(p.dataReader);
+    out += "LatticeSize: " + std::to_string(lcm.latticesize) + "\n";
+    return out;
+}
+
+string Solver::solve(float maxError,
+                     bool stopAfterError,
+                     bool iterative,
+                     function<vector<float>(RCover*)> error_callback,
+                     function<vector<float>(RCover*)> fast_error_callback,
+                     function<float(RCover*)> predictor_error_callback,
+                     bool error_is_null,
+                     bool fast_error_is_null,
+                     int maxdepth,
+                     int minsup,
+                     bool infoGain,
+                     bool infoAsc,
+                     bool repeatSort,
+                     int timeLimit,
+                     map<int, pair<int, int>> *continuousMap,
+                     bool nps_param,
+                     bool verbose_param,
+                     bool predict,
+                     string error_plugin_path,
+                     size_t error_plugin_address,
+                     bool anytime,
+                     function<bool(string, float, float, float)> solution_callback,
+                     bool solution_is_null,
+                     int *warm_tree,
+                     int warm_tree_size,
+                     vector<string> *depthResults,
+                     int maxLeaves,
+                     string checkpointPath,
+                     float checkpointInterval) {
+    lock_guard<mutex> lock(cacheMutex);
+
+    std::cout << "TESTING STUFF" << std::endl;
+    auto begin = chrono::steady_clock::now();
 
     function<vector<float>(RCover*)> *error_callback_pointer = &error_callback;
     function<vector<float>(RCover*)> *fast_error_callback_pointer = &fast_error_callback;
@@ -63,66 +438,562 @@ string search(//std::function<float(Array<int>::iterator)> callback,
         fast_error_callback_pointer = nullptr;
     if(!predict)
         predictor_error_callback_pointer = nullptr;
+    function<bool(string, float, float, float)> *solution_callback_pointer = solution_is_null ? nullptr : &solution_callback;
+
+    // in anytime mode, the most promising attributes are explored first at each level, unless an order is given, so
+    // that good trees are found early
+    if (anytime && !infoGain) {
+        infoGain = true;
+        infoAsc = false;
+        repeatSort = true;
+    }
 
     //cout << "print " << fast_error_callback->pyFunction << endl;
-    nps = nps_param;
-    verbose = verbose_param;
+    if (maxLeaves > 0 && (!error_is_null || !fast_error_is_null || predict || !error_plugin_path.empty() || error_plugin_address != 0))
+        throw invalid_argument("the maximum number of leaves needs the misclassification error");
+
+    // load the native error function first as it is the only step which can fail
+    ErrorPlugin *error_plugin = nullptr;
+    if (!error_plugin_path.empty())
+        error_plugin = ErrorPlugin::load(error_plugin_path);
+    else if (error_plugin_address != 0)
+        error_plugin = ErrorPlugin::fromAddress(error_plugin_address);
+
+    Logger::enable = verbose_param;
     string out = "";
-    Trie *trie = new Trie;
-    Query *query = NULL;
 
     // std::cout << warm[0] << warm[1] << warm[2] << warm[11] << std::endl;
     // std::cout << ntransactions << std::endl;
 
-    DataManager *dataReader = new DataManager(supports, ntransactions, nattributes, nclasses, data, target, warm);
+    out = "TrainingDistribution: ";
+    forEachClass(i, dataReader->getNClasses())
+    out += std::to_string(dataReader->getSupports()[i]) + " ";
+    out += "\n";
+    //out += "(nItems, nTransactions) : ( " << std::to_string(dataReader->getNAttributes()*2) << ", " << std::to_string(dataReader->getNTransactions()) << " )" << endl;
+
+    if (error_plugin != nullptr)
+        error_plugin->init(dataReader);
 
-    if (save)
-        return 0;
+    // the error function is chosen once here, each one having its own instantiation of the search
+    SearchParameters parameters = {dataReader, experror, error_plugin, error_callback_pointer,
+                                   fast_error_callback_pointer, predictor_error_callback_pointer,
+                                   solution_callback_pointer, maxError,
+                                   stopAfterError, iterative, maxdepth, minsup, infoGain, infoAsc, repeatSort,
+                                   timeLimit, continuousMap != NULL, nps_param, warm_tree, warm_tree_size,
+                                   depthResults, nullptr, nullptr, checkpointInterval};
+    if (depthResults != nullptr) // each iteration gives the tree of one depth
+        parameters.iterative = true;
+    // the last best tree only warm starts the searches of the misclassification error, for which it is kept: the tree
+    // of another error function, which may change between the searches, would bound nothing
+    bool callback = error_callback_pointer != nullptr || predictor_error_callback_pointer != nullptr ||
+                    (error_plugin == nullptr && fast_error_callback_pointer != nullptr);
+    vector<int> priorTree;
+    if (warm_tree_size == 0 && !callback && error_plugin == nullptr) {
+        priorTree.swap(lastTree);
+        parameters.warmTree = priorTree.data();
+        parameters.warmTreeSize = (int) priorTree.size();
+    }
+    // only the cache of the misclassification error with the pruned search is kept: the other error functions may
+    // change between the searches and the iterative search keeps solutions of several depths
+    bool complete = false;
+    vector<int> bestTree;
+    if (callback) {
+        Trie<Error> cache;
+        out = runSearch<CallbackError>(parameters, &cache, complete, bestTree);
+    }
+    else if (error_plugin != nullptr) {
+        Trie<Error> cache;
+        out = runSearch<PluginError>(parameters, &cache, complete, bestTree);
+    }
+    else if (maxLeaves > 0)
+        out = runLeafBudgetSearch(parameters, maxLeaves, lastTree);
+    else if (parameters.iterative) {
+        Trie<CountError> cache;
+        out = runSearch<MisclassificationError>(parameters, &cache, complete, lastTree);
+    }
+    else {
+        prepareCache(maxdepth, minsup, maxError);
+        function<void(const vector<Node>&)> checkpoint = [&](const vector<Node> &pending) {
+            writeCheckpoint(checkpointPath, pending);
+        };
+        if (!checkpointPath.empty())
+            parameters.checkpoint = &checkpoint;
+        out = runSearch<MisclassificationError>(parameters, trie, trieComplete, lastTree);
+    }
+    if (lastTree.empty())
+        lastTree.swap(priorTree);
 
-    //create error object and initialize it in the next
-    ExpError *experror;
-    experror = new ExpError_Zero;
+    out += "RunTime: " + std::to_string(chrono::duration<float>(chrono::steady_clock::now() - begin).count());
 
-    if (maxError <= 0)
-        query = new Query_TotalFreq(trie, dataReader, experror, timeLimit, continuousMap, error_callback_pointer, fast_error_callback_pointer, predictor_error_callback_pointer);
-    else
-        query = new Query_TotalFreq(trie, dataReader, experror, timeLimit, continuousMap, error_callback_pointer, fast_error_callback_pointer, predictor_error_callback_pointer, maxError, stopAfterError);
+    delete error_plugin;
 
-    query->maxdepth = maxdepth;
-    query->minsup = minsup;
+    return out;
+}
 
-    out = "TrainingDistribution: ";
-    forEachClass(i)
-    out += std::to_string(dataReader->getSupports()[i]) + " ";
-    out += "\n";
-    //out += "(nItems, nTransactions) : ( " << std::to_string(dataReader->getNAttributes()*2) << ", " << std::to_string(dataReader->getNTransactions()) << " )" << endl;
+// number of transactions of the cover misclassified by the leaves of the tree below the node. When transactions is
+// given, it receives their ids
+template<class E>
+int misclassified(Trie<E> *trie, Node node, RCover *cover, Supports supports, vector<Transaction> *transactions = nullptr) {
+    if (trie->left(node) == NO_NODE) {
+        pair<Supports, Support> classSupports = cover->getSupportPerClass(supports);
+        if (transactions != nullptr)
+            for (Class c = 0; c < cover->dm->getNClasses(); ++c)
+                if (c != trie->test(node))
+                    transactions->insert(transactions->end(), cover->tids, cover->tids + cover->getClassTransactionsID(c));
+        return classSupports.second - classSupports.first[trie->test(node)];
+    }
+    int error = 0;
+    for (int value = 0; value < 2; ++value) {
+        cover->intersect(trie->test(node), value);
+        error += misclassified(trie, value ? trie->right(node) : trie->left(node), cover, supports, transactions);
+        cover->backtrack();
+    }
+    return error;
+}
 
-    void *lcm;
-    if (iterative) {
-        lcm = new LcmIterative(dataReader, query, trie, infoGain, infoAsc, repeatSort);
-        ((LcmIterative *) lcm)->run();
-    } else {
-        lcm = new LcmPruned(dataReader, query, trie, infoGain, infoAsc, repeatSort);
-        ((LcmPruned *) lcm)->run();
+// tree below the node in the format of the ensembles
+template<class E>
+void saveEnsembleTree(Trie<E> *trie, Node node, vector<int> &tree) {
+    if (trie->left(node) == NO_NODE) {
+        tree.push_back(-1 - trie->test(node));
+        return;
     }
+    tree.push_back(trie->test(node));
+    saveEnsembleTree(trie, trie->right(node), tree);
+    saveEnsembleTree(trie, trie->left(node), tree);
+}
 
-    out = query->printResult(dataReader);
+// search a tree with the error function on the transactions of the training mask, testing the candidate attributes
+// only if some are given. The transactions of the validation mask misclassified by the tree are counted. When tree is
+// given, it receives the tree in the format of the ensembles, and when misclassifiedIds is given, it receives the ids
+// of the transactions of the validation mask misclassified
+template<class ErrorFunction>
+TreeResult searchMasked(const SearchParameters &p, const bitset<M> *training, const bitset<M> *validation,
+                        const vector<Attribute> &attributes, vector<int> *tree = nullptr,
+                        vector<Transaction> *misclassifiedIds = nullptr) {
+    typedef typename ErrorFunction::Error E;
+    DataManager *dataReader = p.dataReader;
+    Trie<E> trie;
+    Query_TotalFreq<ErrorFunction> query(&trie, dataReader, p.experror, p.timeLimit, false);
+    query.maxdepth = p.maxdepth;
+    query.minsup = p.minsup;
+    query.trainingMask = training;
+    query.attributes = attributes;
+    query.weights = p.weights;
+    Supports supports = zeroSupports(dataReader->getNClasses());
+    Supports trainingSupports = zeroSupports(dataReader->getNClasses());
+    RCover trainingCover(dataReader, training);
+    trainingCover.getSupportPerClass(trainingSupports);
+    query.classSupports = trainingSupports;
 
-    if (iterative)
-        out += "LatticeSize: " + std::to_string(((LcmIterative *) lcm)->latticesize) + "\n";
-    else
-        out += "LatticeSize: " + std::to_string(((LcmPruned *) lcm)->latticesize) + "\n";
+    LcmPruned<Query_TotalFreq<ErrorFunction>> lcm(dataReader, &query, &trie, p.infoGain, p.infoAsc, p.repeatSort);
+    lcm.run();
+
+    TreeResult result = {"", (float) trie.error(query.realroot), -1, lcm.latticesize, query.timeLimitReached};
+    if (trie.error(query.realroot) < noError<E>()) {
+        result.tree = query.printTree(query.realroot);
+        RCover validationCover(dataReader, validation);
+        result.validationError = misclassified(&trie, query.realroot, &validationCover, supports, misclassifiedIds);
+        if (tree != nullptr)
+            saveEnsembleTree(&trie, query.realroot, *tree);
+    }
+    deleteSupports(supports);
+    deleteSupports(trainingSupports);
+    return result;
+}
 
-    out += "RunTime: " + std::to_string((clock() - t) / (float) CLOCKS_PER_SEC);
+// run the tasks numbered from 0 to n - 1 with nThreads threads, or one per core when nThreads is not positive. Each
+// thread takes the next task until none remains and gives it its NUMA node. On a host of several nodes, the threads
+// are spread over the nodes and pinned to the cpus of theirs, the calling thread only waiting for them. The first
+// exception thrown by a task is thrown again at the end
+void parallelFor(int n, int nThreads, const function<void(int, int)> &task) {
+    if (nThreads <= 0)
+        nThreads = max((int) thread::hardware_concurrency(), 1);
+    nThreads = min(nThreads, n);
+    const vector<vector<int>> &nodes = numaNodes();
+    int nNodes = (int) nodes.size();
 
-    if (iterative)
-        delete ((LcmIterative*)lcm);
-    else
-        delete ((LcmPruned*)lcm);
-    delete trie;
-    delete query;
-    delete dataReader;
-    delete experror;
+    atomic<int> next(0);
+    vector<exception_ptr> errors(max(nThreads, 0));
+    auto work = [&](int worker) {
+        int node = worker % nNodes;
+        if (nNodes > 1)
+            pinThread(nodes[node]);
+        try {
+            for (int i = next++; i < n; i = next++)
+                task(i, node);
+        } catch (...) {
+            errors[worker] = current_exception();
+        }
+    };
+    vector<thread> workers;
+    for (int worker = nNodes > 1 ? 0 : 1; worker < nThreads; ++worker)
+        workers.emplace_back(work, worker);
+    if (nThreads > 0 && nNodes == 1)
+        work(0);
+    for (thread &worker : workers)
+        worker.join();
+    for (exception_ptr &error : errors)
+        if (error)
+            rethrow_exception(error);
+}
+
+void Solver::replicateData() {
+    if (!numaReplicas || numaNodes().size() == 1)
+        return;
+    // the cross-validations and the ensembles of several threads copy the data once, the others waiting for it
+    lock_guard<mutex> lock(replicasMutex);
+    if (!replicas.empty())
+        return;
+    // each replica is copied by a thread of its node, whose first writes place its pages there
+    replicas.assign(numaNodes().size(), nullptr);
+    vector<thread> copiers;
+    for (int node = 0; node < (int) replicas.size(); ++node)
+        copiers.emplace_back([this, node]() {
+            pinThread(numaNodes()[node]);
+            replicas[node] = new DataManager(*dataReader);
+        });
+    for (thread &copier : copiers)
+        copier.join();
+}
+
+DataManager *Solver::localData(int node) {
+    lock_guard<mutex> lock(replicasMutex);
+    return numaReplicas && !replicas.empty() ? replicas[node] : dataReader;
+}
 
+// parameters of the searches of the cross-validations and of the ensembles, which only use the misclassification error
+SearchParameters maskedSearchParameters(DataManager *dataReader, ExpError *experror, int maxdepth, int minsup,
+                                        bool infoGain, bool infoAsc, bool repeatSort, int timeLimit) {
+    SearchParameters parameters = {dataReader, experror, nullptr, nullptr, nullptr, nullptr, nullptr, NO_ERR, false,
+                                   false, maxdepth, minsup, infoGain, infoAsc, repeatSort, timeLimit, false, false,
+                                   nullptr, 0, nullptr, nullptr, nullptr, 0};
+    return parameters;
+}
+
+vector<TreeResult> Solver::crossValidate(const int *folds, int nfolds, int maxdepth, int minsup, bool infoGain,
+                                         bool infoAsc, bool repeatSort, int timeLimit, int nThreads) {
+    SearchParameters parameters = maskedSearchParameters(dataReader, experror, maxdepth, minsup, infoGain, infoAsc,
+                                                         repeatSort, timeLimit);
+    vector<TreeResult> results(nfolds);
+    // the folds share the data, which is only read, or its replica on the node of their thread
+    replicateData();
+    parallelFor(nfolds, nThreads, [&](int fold, int node) {
+        SearchParameters foldParameters = parameters;
+        foldParameters.dataReader = localData(node);
+        // masks of the transactions out of the fold and in it, transaction t being bit t%M of the word nWords-1-t/M
+        // as in the columns of the data
+        int nWords = dataReader->nWords;
+        vector<bitset<M>> training(nWords), validation(nWords);
+        for (int t = 0; t < dataReader->getNTransactions(); ++t)
+            (folds[t] == fold ? validation : training)[nWords - 1 - t / M].set(t % M);
+        results[fold] = searchMasked<MisclassificationError>(foldParameters, training.data(), validation.data(), vector<Attribute>());
+    });
+    return results;
+}
+
+vector<TreeResult> Solver::trainEnsemble(const int *samples, const int *features, int ntrees, int maxdepth,
+                                         int minsup, bool infoGain, bool infoAsc, bool repeatSort, int timeLimit,
+                                         int nThreads, Ensemble *ensemble) {
+    SearchParameters parameters = maskedSearchParameters(dataReader, experror, maxdepth, minsup, infoGain, infoAsc,
+                                                         repeatSort, timeLimit);
+    Transaction ntransactions = dataReader->getNTransactions();
+    Attribute nattributes = dataReader->getNAttributes();
+    vector<TreeResult> results(ntrees);
+    ensemble->nclasses = dataReader->getNClasses();
+    ensemble->trees.assign(ntrees, vector<int>());
+    replicateData();
+    parallelFor(ntrees, nThreads, [&](int i, int node) {
+        // the transactions out of the sample of the tree validate it
+        int nWords = dataReader->nWords;
+        vector<bitset<M>> sample(nWords), outOfSample(nWords);
+        for (int t = 0; t < ntransactions; ++t)
+            (samples[(size_t) i * ntransactions + t] ? sample : outOfSample)[nWords - 1 - t / M].set(t % M);
+        vector<Attribute> attributes;
+        if (features != nullptr)
+            for (Attribute attribute = 0; attribute < nattributes; ++attribute)
+                if (features[(size_t) i * nattributes + attribute])
+                    attributes.push_back(attribute);
+        SearchParameters treeParameters = parameters;
+        treeParameters.dataReader = localData(node);
+        if (features != nullptr && attributes.empty()) // a tree without attribute is a leaf
+            treeParameters.maxdepth = 0;
+        results[i] = searchMasked<MisclassificationError>(treeParameters, sample.data(), outOfSample.data(), attributes, &ensemble->trees[i]);
+    });
+    return results;
+}
+
+vector<TreeResult> Solver::boost(int ntrees, int maxdepth, int minsup, bool infoGain, bool infoAsc, bool repeatSort,
+                                 int timeLimit, Ensemble *ensemble) {
+    SearchParameters parameters = maskedSearchParameters(dataReader, experror, maxdepth, minsup, infoGain, infoAsc,
+                                                         repeatSort, timeLimit);
+    Transaction ntransactions = dataReader->getNTransactions();
+    Class nclasses = dataReader->getNClasses();
+    vector<float> weights(ntransactions, 1.0f / ntransactions);
+    parameters.weights = weights.data();
+    vector<TreeResult> results;
+    ensemble->nclasses = nclasses;
+    ensemble->trees.clear();
+    ensemble->weights.clear();
+    // the rounds reuse the data, the weights only changing the errors of the leaves
+    for (int round = 0; round < ntrees; ++round) {
+        vector<int> tree;
+        vector<Transaction> wrong;
+        TreeResult result = searchMasked<WeightedError>(parameters, nullptr, nullptr, vector<Attribute>(), &tree, &wrong);
+        if (tree.empty())
+            break;
+        float error = 0;
+        for (Transaction t : wrong)
+            error += weights[t];
+        // a tree no better than chance does not join the ensemble, unless it would be empty
+        bool chance = error >= 1 - 1.0f / nclasses;
+        if (chance && !ensemble->trees.empty())
+            break;
+        results.push_back(result);
+        ensemble->trees.push_back(tree);
+        if (error <= 0 || chance) {
+            ensemble->weights.push_back(1);
+            break;
+        }
+        // SAMME: the misclassified transactions weigh more in the next round
+        float alpha = log((1 - error) / error) + log(nclasses - 1.0f);
+        ensemble->weights.push_back(alpha);
+        float factor = exp(alpha), total = 0;
+        for (Transaction t : wrong)
+            weights[t] *= factor;
+        for (float weight : weights)
+            total += weight;
+        for (float &weight : weights)
+            weight /= total;
+    }
+    return results;
+}
+
+vector<RankedTree> Solver::enumerateTrees(int maxTrees, float epsilon, bool pareto, int maxLeaves, int maxdepth,
+                                          int minsup, int timeLimit, int *latticeSize, bool *timeout) {
+    Trie<CountError> cache;
+    Query_TotalFreq<MisclassificationError> query(&cache, dataReader, experror, timeLimit, false);
+    query.maxdepth = maxdepth;
+    query.minsup = minsup;
+    LcmEnumeration<Query_TotalFreq<MisclassificationError>> lcm(dataReader, &query, &cache, maxTrees, epsilon,
+                                                                pareto, maxLeaves);
+    lcm.run();
+
+    vector<RankedTree> trees;
+    for (int i = 0; i < (int) lcm.solutions(lcm.root).size(); ++i) {
+        const LcmEnumeration<Query_TotalFreq<MisclassificationError>>::Solution &solution = lcm.solutions(lcm.root)[i];
+        trees.push_back({lcm.printTree(lcm.root, i), (float) solution.error, 2 * solution.leaves - 1,
+                         lcm.depth(lcm.root, i)});
+    }
+    *latticeSize = lcm.latticesize;
+    *timeout = query.timeLimitReached;
+    return trees;
+}
+
+// result of a worker of the sharded search, in the shared memory. The output of the worker follows it
+struct ShardResult {
+    CountError error; // of the root, noError without tree
+    int latticeSize;
+    bool timeout;
+    bool done; // set once the result is written
+    int length; // of the output, written to the file of the worker
+};
+
+string Solver::solveSharded(int nProcesses, int maxdepth, int minsup, bool infoGain, bool infoAsc, bool repeatSort,
+                            int timeLimit, float maxError) {
+#if defined(_WIN32)
+    throw runtime_error("the sharded search needs POSIX processes");
+#else
+    auto begin = chrono::steady_clock::now();
+    if (nProcesses <= 0)
+        nProcesses = max((int) thread::hardware_concurrency(), 1);
+    nProcesses = max(min(nProcesses, dataReader->getNAttributes()), 1);
+
+    // the shared memory holds the best error of the root found by the workers, then one result per worker, each on its
+    // own cache lines. The output of a worker, whose length depends on its tree, goes to a temporary file of its own
+    size_t stride = (sizeof(ShardResult) + 63) / 64 * 64;
+    size_t length = 64 + stride * nProcesses;
+    void *memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+        throw runtime_error("sharded search: cannot map the shared memory");
+    vector<FILE*> outputs;
+    for (int worker = 0; worker < nProcesses; ++worker) {
+        FILE *output = tmpfile();
+        if (output == nullptr) {
+            for (FILE *file : outputs)
+                fclose(file);
+            munmap(memory, length);
+            throw runtime_error("sharded search: cannot create the output files");
+        }
+        outputs.push_back(output);
+    }
+    static_assert(ATOMIC_INT_LOCK_FREE == 2, "the bound shared by the processes must be lock free");
+    atomic<CountError> *bestError = new (memory) atomic<CountError>(noError<CountError>());
+    auto result = [&](int worker) { return (ShardResult*) ((char*) memory + 64 + stride * worker); };
+
+    vector<pid_t> workers;
+    for (int worker = 0; worker < nProcesses; ++worker) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            // the worker searches the trees whose root tests its attributes, the attributes being dealt in turn
+            try {
+                Trie<CountError> cache;
+                Query_TotalFreq<MisclassificationError> query(&cache, dataReader, experror, timeLimit, false, nullptr,
+                                                              nullptr, nullptr, maxError > 0 ? maxError : NO_ERR);
+                query.maxdepth = maxdepth;
+                query.minsup = minsup;
+                query.rootTests.assign(dataReader->getNAttributes(), false);
+                for (Attribute attribute = worker; attribute < dataReader->getNAttributes(); attribute += nProcesses)
+                    query.rootTests[attribute] = true;
+                function<float()> rootBound = [&]() {
+                    CountError error = bestError->load();
+                    return error == noError<CountError>() ? NO_ERR : (float) error;
+                };
+                function<bool(string, float, float, float)> publish = [&](string, float error, float, float) {
+                    CountError current = bestError->load();
+                    while ((CountError) error < current && !bestError->compare_exchange_weak(current, (CountError) error));
+                    return false;
+                };
+                query.rootBound = &rootBound;
+                query.solution_callback = &publish;
+                LcmPruned<Query_TotalFreq<MisclassificationError>> lcm(dataReader, &query, &cache, infoGain, infoAsc,
+                                                                       repeatSort);
+                lcm.run();
+
+                string out = query.printResult(dataReader);
+                if (fwrite(out.data(), 1, out.size(), outputs[worker]) != out.size() || fflush(outputs[worker]) != 0)
+                    _exit(1);
+                ShardResult *shard = result(worker);
+                shard->error = cache.error(query.realroot);
+                shard->latticeSize = lcm.latticesize;
+                shard->timeout = query.timeLimitReached;
+                shard->length = (int) out.size();
+                shard->done = true;
+            } catch (...) {
+                _exit(1);
+            }
+            _exit(0);
+        }
+        if (pid < 0) {
+            for (pid_t started : workers) {
+                kill(started, SIGKILL);
+                waitpid(started, nullptr, 0);
+            }
+            for (FILE *file : outputs)
+                fclose(file);
+            munmap(memory, length);
+            throw runtime_error("sharded search: cannot start the worker processes");
+        }
+        workers.push_back(pid);
+    }
+    bool failed = false;
+    for (pid_t pid : workers) {
+        int status = 0;
+        if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            failed = true;
+    }
+
+    // the best tree is the one of the first worker with the least error. The search is not complete when a worker
+    // reached the time limit
+    int best = 0, latticeSize = 0;
+    bool timeout = false;
+    for (int worker = 0; worker < nProcesses && !failed; ++worker) {
+        failed = !result(worker)->done;
+        if (failed)
+            break;
+        latticeSize += result(worker)->latticeSize;
+        timeout = timeout || result(worker)->timeout;
+        if (result(worker)->error < result(best)->error)
+            best = worker;
+    }
+    // the offsets of the files are shared with the workers, so the best output is read from the start of its file
+    string out;
+    if (!failed) {
+        out.resize(result(best)->length);
+        rewind(outputs[best]);
+        failed = fread(&out[0], 1, out.size(), outputs[best]) != out.size();
+        if (timeout && !result(best)->timeout)
+            out += "Timeout\n";
+    }
+    for (FILE *file : outputs)
+        fclose(file);
+    munmap(memory, length);
+    if (failed)
+        throw runtime_error("sharded search: a worker process failed");
+    out += "LatticeSize: " + std::to_string(latticeSize) + "\n";
+    out += "RunTime: " + std::to_string(chrono::duration<float>(chrono::steady_clock::now() - begin).count());
     return out;
+#endif
+}
+
+void Ensemble::predict(const int *data, int ntransactions, int nattributes, int *predictions) const {
+    vector<float> votes(nclasses);
+    for (int t = 0; t < ntransactions; ++t) {
+        const int *transaction = data + (size_t) t * nattributes;
+        fill(votes.begin(), votes.end(), 0);
+        for (size_t i = 0; i < trees.size(); ++i) {
+            const vector<int> &tree = trees[i];
+            if (tree.empty())
+                continue;
+            // the positive subtree of a test follows it, the negative one follows the positive subtree
+            size_t pos = 0;
+            while (tree[pos] >= 0) {
+                if (transaction[tree[pos]]) {
+                    ++pos;
+                    continue;
+                }
+                int open = 1;
+                for (++pos; open > 0; ++pos)
+                    open += (tree[pos] >= 0) ? 1 : -1;
+            }
+            votes[-1 - tree[pos]] += weights.empty() ? 1 : weights[i];
+        }
+        predictions[t] = (int) (max_element(votes.begin(), votes.end()) - votes.begin());
+    }
+}
+
+string search(//std::function<float(Array<int>::iterator)> callback,
+              Supports supports,
+              Transaction ntransactions,
+              Attribute nattributes,
+              Class nclasses,
+              Bool *data,
+              Class *target,
+              Class *warm,
+              float maxError,
+              bool stopAfterError,
+              bool iterative,
+              function<vector<float>(RCover*)> error_callback,
+              function<vector<float>(RCover*)> fast_error_callback,
+              function<float(RCover*)> predictor_error_callback,
+              bool error_is_null,
+              bool fast_error_is_null,
+              int maxdepth,
+              int minsup,
+              bool infoGain,
+              bool infoAsc,
+              bool repeatSort,
+              int timeLimit,
+              map<int, pair<int, int>> *continuousMap,
+              bool save,
+              bool nps_param,
+              bool verbose_param,
+              bool predict,
+              string error_plugin_path,
+              size_t error_plugin_address,
+              bool anytime,
+              function<bool(string, float, float, float)> solution_callback,
+              bool solution_is_null,
+              int *warm_tree,
+              int warm_tree_size) {
+    Solver solver(supports, ntransactions, nattributes, nclasses, data, target, warm);
+
+    if (save)
+        return 0;
+
+    return solver.solve(maxError, stopAfterError, iterative, error_callback, fast_error_callback,
+                        predictor_error_callback, error_is_null, fast_error_is_null, maxdepth, minsup, infoGain,
+                        infoAsc, repeatSort, timeLimit, continuousMap, nps_param, verbose_param, predict,
+                        error_plugin_path, error_plugin_address, anytime, solution_callback, solution_is_null,
+                        warm_tree, warm_tree_size);
 }
@@ -1,22 +1,18 @@
 #include "globals.h"
 #include <math.h>
 
-Class nclasses;
-Attribute nattributes;
-std::map<int,int> attrFeat;
-
-Supports newSupports () {
+Supports newSupports ( Class nclasses ) {
   return new Support[nclasses];
 }
 
-Supports zeroSupports () {
-  Supports supports = newSupports();
-  zeroSupports ( supports );
+Supports zeroSupports ( Class nclasses ) {
+  Supports supports = newSupports ( nclasses );
+  zeroSupports ( supports, nclasses );
   return supports;
 }
 
-void zeroSupports ( Supports supports ) {
-  forEachClass ( i ) 
+void zeroSupports ( Supports supports, Class nclasses ) {
+  forEachClass ( i, nclasses )
     supports[i] = 0;
 }
 
@@ -24,31 +20,31 @@ void deleteSupports ( Supports supports ) {
   delete[] supports;
 }
 
-void copySupports ( Supports src, Supports dest ) {
-  forEachClass ( i )
+void copySupports ( Supports src, Supports dest, Class nclasses ) {
+  forEachClass ( i, nclasses )
     dest[i] = src[i];
 }
 
-Supports copySupports ( Supports supports ) {
-  Supports supports2 = newSupports ();
-  copySupports ( supports, supports2 );
+Supports copySupports ( Supports supports, Class nclasses ) {
+  Supports supports2 = newSupports ( nclasses );
+  copySupports ( supports, supports2, nclasses );
   return supports2;
 }
 
-Support sumSupports ( Supports supports ) {
+Support sumSupports ( Supports supports, Class nclasses ) {
   Support sum = 0;
-  forEachClass ( i )
+  forEachClass ( i, nclasses )
     sum += supports[i];
   return sum;
 }
 
-void minSupports ( Supports src1, Supports src2, Supports dest ) {
-  forEachClass ( i )
+void minSupports ( Supports src1, Supports src2, Supports dest, Class nclasses ) {
+  forEachClass ( i, nclasses )
     dest[i] = src1[i] - src2[i];
 }
 
-void plusSupports ( Supports src1, Supports src2, Supports dest ) {
-  forEachClass ( i )
+void plusSupports ( Supports src1, Supports src2, Supports dest, Class nclasses ) {
+  forEachClass ( i, nclasses )
     dest[i] = src1[i] + src2[i];
 }
 
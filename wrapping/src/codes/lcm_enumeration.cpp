@@ -0,0 +1,157 @@
+#include "lcm_enumeration.h"
+#include "query_totalfreq.h"
+#include <algorithm>
+#include <ctime>
+#include <climits>
+
+template<class Query_>
+LcmEnumeration<Query_>::LcmEnumeration ( DataManager *dataReader, Query_ *query, Trie<Error> *trie, int maxTrees, float epsilon, bool pareto, int maxLeaves ) :
+        dataReader ( dataReader ), query ( query ), trie ( trie ), maxTrees ( max ( maxTrees, 1 ) ), epsilon ( epsilon ), pareto ( pareto ),
+        maxLeaves ( pareto ? max ( maxLeaves, 0 ) : 0 ) {
+}
+
+template<class Query_>
+void LcmEnumeration<Query_>::run () {
+    query->setStartTime ();
+    RCover rootCover ( dataReader, query->trainingMask );
+    cover = &rootCover;
+    vector<Item> itemset;
+    root = recurse ( itemset, 0 );
+    query->realroot = root;
+    cover = nullptr;
+}
+
+template<class Query_>
+Node LcmEnumeration<Query_>::recurse ( vector<Item> &itemset, Depth depth ) {
+    Node node = trie->insert ( Array<Item> ( itemset.data (), (int) itemset.size () ) );
+    if ( trie->hasData ( node ) ) // the list of the node is already known
+        return node;
+    ++latticesize;
+    query->initData ( node, cover, noError<Error> (), depth );
+    if ( lists.size () <= (size_t) node )
+        lists.resize ( node + 1 );
+
+    Error leafError = trie->leafError ( node );
+    vector<Solution> candidates;
+    candidates.push_back ( { leafError, 1, -1 - trie->test ( node ), { NO_NODE, NO_NODE }, { 0, 0 } } );
+
+    int budget = maxLeaves > 0 ? maxLeaves - depth : INT_MAX; // leaves left to the subtrees of the node
+    if ( depth < query->maxdepth && leafError > trie->lowerBound ( node ) && budget >= 2 ) {
+        for ( Attribute attribute = 0; attribute < dataReader->getNAttributes (); ++attribute ) {
+            if ( query->timeLimit > 0 && query->runTime () >= query->timeLimit )
+                query->timeLimitReached = true;
+            if ( query->timeLimitReached )
+                break;
+            // an attribute already tested gives an empty branch
+            if ( binary_search ( itemset.begin (), itemset.end (), item ( attribute, 0 ) ) ||
+                 binary_search ( itemset.begin (), itemset.end (), item ( attribute, 1 ) ) )
+                continue;
+            bool frequent = true;
+            for ( int value = 0; value < 2 && frequent; ++value ) {
+                cover->intersect ( attribute, value );
+                frequent = cover->getSupport () >= query->minsup;
+                cover->backtrack ();
+            }
+            if ( !frequent )
+                continue;
+
+            Node children[2];
+            for ( int value = 0; value < 2; ++value ) {
+                Item added = item ( attribute, value );
+                itemset.insert ( lower_bound ( itemset.begin (), itemset.end (), added ), added );
+                cover->intersect ( attribute, value );
+                children[value] = recurse ( itemset, depth + 1 );
+                cover->backtrack ();
+                itemset.erase ( lower_bound ( itemset.begin (), itemset.end (), added ) );
+            }
+
+            // the lists are sorted by error, so that the pairs of subtrees stop once they are not better than the leaf
+            const vector<Solution> &negatives = lists[children[0]], &positives = lists[children[1]];
+            for ( int i = 0; i < (int) negatives.size (); ++i ) {
+                for ( int j = 0; j < (int) positives.size (); ++j ) {
+                    Error error = negatives[i].error + positives[j].error;
+                    if ( error >= leafError )
+                        break;
+                    if ( negatives[i].leaves + positives[j].leaves > budget )
+                        continue;
+                    candidates.push_back ( { error, negatives[i].leaves + positives[j].leaves, attribute,
+                                             { children[0], children[1] }, { i, j } } );
+                }
+            }
+            if ( (int) candidates.size () > 2 * maxTrees || pareto )
+                select ( candidates );
+        }
+    }
+
+    select ( candidates );
+    lists[node].swap ( candidates );
+    return node;
+}
+
+template<class Query_>
+void LcmEnumeration<Query_>::select ( vector<Solution> &candidates ) {
+    sort ( candidates.begin (), candidates.end (), [] ( const Solution &a, const Solution &b ) {
+        return a.error < b.error || ( a.error == b.error && a.leaves < b.leaves );
+    } );
+    if ( pareto ) { // a subtree is dominated by the ones before it unless it has fewer leaves than all of them
+        int kept = 0;
+        for ( const Solution &candidate : candidates )
+            if ( kept == 0 || candidate.leaves < candidates[kept - 1].leaves )
+                candidates[kept++] = candidate;
+        candidates.resize ( kept );
+        return;
+    }
+    int kept = min ( (int) candidates.size (), maxTrees );
+    while ( kept > 1 && (float) ( candidates[kept - 1].error - candidates[0].error ) > epsilon )
+        --kept;
+    candidates.resize ( kept );
+}
+
+template<class Query_>
+string LcmEnumeration<Query_>::printTree ( Node node, int index ) {
+    string out;
+    printTree ( node, index, out );
+    return out;
+}
+
+template<class Query_>
+void LcmEnumeration<Query_>::printTree ( Node node, int index, string &out ) {
+    const Solution &solution = lists[node][index];
+    if ( solution.test < 0 ) {
+        out += "{\"value\": " + std::to_string ( -1 - solution.test ) + ", \"error\": " + std::to_string ( (double) solution.error ) + "}";
+        return;
+    }
+    // the positive subtree is printed first, as in printResult
+    out += "{\"feat\": " + std::to_string ( solution.test ) + ", \"left\": ";
+    printTree ( solution.children[1], solution.indices[1], out );
+    out += ", \"right\": ";
+    printTree ( solution.children[0], solution.indices[0], out );
+    out += "}";
+}
+
+template<class Query_>
+int LcmEnumeration<Query_>::depth ( Node node, int index ) {
+    const Solution &solution = lists[node][index];
+    if ( solution.test < 0 )
+        return 0;
+    return 1 + max ( depth ( solution.children[0], solution.indices[0] ), depth ( solution.children[1], solution.indices[1] ) );
+}
+
+template<class Query_>
+void LcmEnumeration<Query_>::saveSolution ( Node node, int index ) {
+    const Solution &solution = lists[node][index];
+    trie->error ( node ) = solution.error;
+    trie->size ( node ) = 2 * solution.leaves - 1;
+    if ( solution.test < 0 ) {
+        trie->test ( node ) = -1 - solution.test;
+        trie->left ( node ) = trie->right ( node ) = NO_NODE;
+        return;
+    }
+    trie->test ( node ) = solution.test;
+    trie->left ( node ) = solution.children[0];
+    trie->right ( node ) = solution.children[1];
+    saveSolution ( solution.children[0], solution.indices[0] );
+    saveSolution ( solution.children[1], solution.indices[1] );
+}
+
+template class LcmEnumeration<Query_TotalFreq<MisclassificationError>>;
@@ -3,7 +3,7 @@
 //
 
 #include "lcm_iterative.h"
-#include "query_best.h" // if cannot link is specified, we need a clustering problem!!!
+#include "query_totalfreq.h"
 #include "logger.h"
 #include <iostream>
 #include <limits.h>
@@ -12,6 +12,7 @@
 #include <map>
 #include <unordered_set>
 #include <unordered_map>
+#include <algorithm>
 #include "dataContinuous.h"
 #include "rCover.h"
 
@@ -22,14 +23,17 @@ struct Hash {
     }
 };
 
-LcmIterative::LcmIterative ( DataManager *dataReader, Query *query, Trie *trie, bool infoGain, bool infoAsc, bool allDepths):
+template<class Query_>
+LcmIterative<Query_>::LcmIterative ( DataManager *dataReader, Query_ *query, Trie<Error> *trie, bool infoGain, bool infoAsc, bool allDepths):
         dataReader ( dataReader ), query ( query ), trie ( trie ), infoGain ( infoGain ), infoAsc ( infoAsc ), allDepths ( allDepths ) {
 }
 
-LcmIterative::~LcmIterative() {
+template<class Query_>
+LcmIterative<Query_>::~LcmIterative() {
 }
 
-TrieNode* LcmIterative::recurse ( Array<Item> itemset_,
+template<class Query_>
+Node LcmIterative<Query_>::recurse ( Array<Item> itemset_,
                                Item added,
                                Array<pair<bool,Attribute > > a_attributes,
                                RCover* a_transactions,
@@ -41,16 +45,17 @@ TrieNode* LcmIterative::recurse ( Array<Item> itemset_,
     Logger::showMessageAndReturn("\t\tAppel recursif. CMD : ", currentMaxDepth, " and current depth : ", depth);
 
     if ( query->timeLimit > 0 ){
-        float runtime = ( clock () - query->startTime ) / (float) CLOCKS_PER_SEC;
-        if( runtime >= query->timeLimit )
+        if( query->runTime() >= query->timeLimit )
             query->timeLimitReached = true;
     }
 
     Array<Item> itemset;
-    itemset.alloc ( itemset_.size + 1 );
 
-    if (added != NO_ITEM)
+    if (added != NO_ITEM) {
+        itemset = buffers->itemset(depth);
+        itemset.resize(itemset_.size + 1);
         addItem ( itemset_, added, itemset );
+    }
     else
         itemset = itemset_;
 
@@ -60,34 +65,42 @@ TrieNode* LcmIterative::recurse ( Array<Item> itemset_,
     Logger::showMessage("itemset après ajout : ");
     printItemset(itemset);
 
-    TrieNode *node = trie->insert ( itemset );
+    Node node = trie->insert ( itemset );
 
-    if (node->data) {//node already exists
+    if (trie->hasData(node)) {//node already exists
 //        if last solution can be used, we will return it. Otherwise, we will continue the search
         Logger::showMessageAndReturn("le noeud exists");
 
-        Error leafError = ( (QueryData_Best*) node->data )->leafError;
-        Error* nodeError = &( ( (QueryData_Best*) node->data )->error );
-        Error storedInitUb = ( (QueryData_Best*) node->data )->initUb;
+        Error leafError = trie->leafError(node);
+        Error* nodeError = &( trie->error(node) );
+        Error storedInitUb = trie->initUb(node);
         //Error initUb = min(parent_ub, leafError);
         //Error initUb = min(parent_ub, lastBest);
         Error initUb = parent_ub;
-        Depth* solDepth = &( (QueryData_Best*) node->data )->solutionDepth;
+        Depth solDepth = trie->solutionDepth(node);
+
+        // the result of a search which did not depend on the depth is the one of this depth
+        if ( solDepth < currentMaxDepth && settled(node) ){
+            trie->setSolutionDepth(node, currentMaxDepth);
+            solDepth = currentMaxDepth;
+        }
 
-        if( *nodeError < FLT_MAX && currentMaxDepth == *solDepth ) { //if( nodeError != FLT_MAX ) best solution has been already found
+        if( *nodeError < noError<Error>() && currentMaxDepth == solDepth ) { //if( nodeError != noError<Error>() ) best solution has been already found
             Logger::showMessageAndReturn("solution avait été trouvée pour cette profondeur ", currentMaxDepth, " et vaut : ", *nodeError);
             return node;
         }
 
-        if (!nps)
-            if ( initUb <= storedInitUb && currentMaxDepth == *solDepth ) { //solution has not been found last time but the result is the same for this time
+        if (!query->nps)
+            if ( initUb <= storedInitUb && currentMaxDepth == solDepth ) { //solution has not been found last time but the result is the same for this time
                 Logger::showMessageAndReturn("y'avait pas de solution pour cette profonceur ", currentMaxDepth, " mais c'est pareil cette fois-ci. Ancien init =",
                                              storedInitUb, " et nouveau = ", initUb);
                 return node;
             }
 
-        if ( leafError == 0 ){ // if we have a node already visited with lErr = 0, we can return the last solution
-            Logger::showMessageAndReturn("l'erreur est nulle");
+        if ( leafError <= trie->lowerBound(node) || *nodeError <= trie->lowerBound(node) ){ // the last solution reached the lower bound, a larger depth cannot improve it
+            Logger::showMessageAndReturn("l'erreur ne peut plus être améliorée");
+            if ( !settled(node) )
+                setSettled(node, true, solDepth);
             return node;
         }
 
@@ -95,7 +108,7 @@ TrieNode* LcmIterative::recurse ( Array<Item> itemset_,
             Logger::showMessageAndReturn("on a atteint la profondeur maximale pour cette itération. parent boud = ", parent_ub, " et leaf error = ", leafError);
 
             if ( parent_ub < leafError ){
-                *nodeError = FLT_MAX;
+                *nodeError = noError<Error>();
                 Logger::showMessageAndReturn("pas de solution");
             }
             else{
@@ -113,14 +126,17 @@ TrieNode* LcmIterative::recurse ( Array<Item> itemset_,
 
     // allocate itemset info
     Array<pair<bool,Attribute> > a_attributes2;
-    Error initUb = FLT_MAX;
+    Error initUb = noError<Error>();
+    // whether the tree of the last depth is worse than the bound given by the parent. It is not a solution for this
+    // depth unless the search improves it
+    bool lastTreeAboveBound = false;
 
 
-    if ( !node->data || (node->data && ( (QueryData_Best*) node->data )->solutionDepth < currentMaxDepth) ){
+    if ( !trie->hasData(node) || trie->solutionDepth(node) < currentMaxDepth ){
         // case 1 : when the node did not exist and
         // case 2 : when the node exists but without solution for this depth
 
-        if (!node->data){ //node did not exist
+        if (!trie->hasData(node)){ //node did not exist
             Logger::showMessageAndReturn("Nouveau noeud");
             latticesize++;
 //            if ( latticesize % 1000 == 0 )
@@ -128,45 +144,45 @@ TrieNode* LcmIterative::recurse ( Array<Item> itemset_,
 
             //STEP 2 : call initData of query
             //<=================== START STEP 2 ===================>
-            Error bound = parent_ub;
-            node->data = query->initData(a_transactions, parent_ub, query->minsup,currentMaxDepth);
+            query->initData(node, a_transactions, parent_ub, currentMaxDepth);
 
             //initialize the bound. it will be used for children in for loop
-            initUb = ((QueryData_Best*) node->data)->initUb;
+            initUb = trie->initUb(node);
 
-            Logger::showMessageAndReturn("après initialisation du nouveau noeud. parent bound = ", parent_ub, " et leaf error = ", ((QueryData_Best*) node->data)->leafError, " init bound = ", initUb, " et solution depth = ", ((QueryData_Best*) node->data)->solutionDepth);
+            Logger::showMessageAndReturn("après initialisation du nouveau noeud. parent bound = ", parent_ub, " et leaf error = ", trie->leafError(node), " init bound = ", initUb, " et solution depth = ", trie->solutionDepth(node));
             //<===================  END STEP 2  ===================>
 
 
             //STEP 3 : Case in which we cannot split more
             //cout << "current depth = " << depth << " and current max depth = " << currentMaxDepth << endl;
             //<=================== START STEP 3 ===================>
-            if ( ((QueryData_Best*) node->data)->leafError == 0 ){
+            if ( trie->leafError(node) == 0 ){
                 //when leaf error equals 0 all solution parameters have already been stored by initData apart from node error
-                ((QueryData_Best*) node->data)->error = ((QueryData_Best*) node->data)->leafError;
-                //((QueryData_Best*) node->data)->solutionDepth = currentMaxDepth;
-                Logger::showMessageAndReturn("l'erreur est nulle. node error = leaf error = ", ((QueryData_Best*) node->data)->error);
+                trie->error(node) = trie->leafError(node);
+                //trie->setSolutionDepth(node, currentMaxDepth);
+                setSettled(node, true, currentMaxDepth);
+                Logger::showMessageAndReturn("l'erreur est nulle. node error = leaf error = ", trie->error(node));
                 return node;
             }
 
             if ( depth == currentMaxDepth){// query->maxdepth ){
-                Logger::showMessageAndReturn("on a atteint la profondeur maximale pour cette itération. parent bound = ", parent_ub, " et leaf error = ", ((QueryData_Best*) node->data)->leafError);
+                Logger::showMessageAndReturn("on a atteint la profondeur maximale pour cette itération. parent bound = ", parent_ub, " et leaf error = ", trie->leafError(node));
 
-                //((QueryData_Best*) node->data)->solutionDepth = currentMaxDepth;
+                //trie->setSolutionDepth(node, currentMaxDepth);
 
-                if ( parent_ub < ((QueryData_Best*) node->data)->leafError ){
-                    ((QueryData_Best*) node->data)->error = FLT_MAX;
+                if ( parent_ub < trie->leafError(node) ){
+                    trie->error(node) = noError<Error>();
                     Logger::showMessageAndReturn("pas de solution");
                 }
                 else{
-                    ((QueryData_Best*) node->data)->error = ((QueryData_Best*) node->data)->leafError;
-                    Logger::showMessageAndReturn("on retourne leaf error = ", ((QueryData_Best*) node->data)->leafError);
+                    trie->error(node) = trie->leafError(node);
+                    Logger::showMessageAndReturn("on retourne leaf error = ", trie->leafError(node));
                 }
                 return node;
             }
 
             if ( query->timeLimitReached ){
-                ((QueryData_Best*) node->data)->error = ((QueryData_Best*) node->data)->leafError;
+                trie->error(node) = trie->leafError(node);
                 return node;
             }
             //<===================  END STEP 3  ===================>
@@ -175,14 +191,17 @@ TrieNode* LcmIterative::recurse ( Array<Item> itemset_,
 
         else{
             Logger::showMessageAndReturn("Le noeud existe mais il n'y a pas de solution à cette profondeur");
-            Error bound = min(parent_ub, ( (QueryData_Best*) node->data )->error );
-            ((QueryData_Best*) node->data)->initUb = bound;
-            ((QueryData_Best*) node->data)->solutionDepth = currentMaxDepth;
-            initUb = ((QueryData_Best*) node->data)->initUb;
-            Logger::showMessageAndReturn("cette fois-ci parent bound = ", parent_ub, " et leaf error = ", ((QueryData_Best*) node->data)->leafError, " init bound = ", initUb, " et solution depth = ", ((QueryData_Best*) node->data)->solutionDepth);
+            saveSolution(node, depth);
+            lastTreeAboveBound = parent_ub < trie->error(node);
+            Error bound = min(parent_ub, trie->error(node) );
+            trie->initUb(node) = bound;
+            trie->setSolutionDepth(node, currentMaxDepth);
+            initUb = trie->initUb(node);
+            Logger::showMessageAndReturn("cette fois-ci parent bound = ", parent_ub, " et leaf error = ", trie->leafError(node), " init bound = ", initUb, " et solution depth = ", trie->solutionDepth(node));
 
             if ( query->timeLimitReached ){
-                ((QueryData_Best*) node->data)->error = ((QueryData_Best*) node->data)->leafError;
+                trie->error(node) = trie->leafError(node);
+                setSettled(node, false, currentMaxDepth);
                 return node;
             }
         }
@@ -190,25 +209,38 @@ TrieNode* LcmIterative::recurse ( Array<Item> itemset_,
 
         //STEP 4 : determine successors
         //<=================== START STEP 4 ===================>
-        a_attributes2 = getSuccessors(a_attributes, a_transactions, added);
+        a_attributes2 = buffers->successors(depth);
+        if ( !successorCache->find(node, a_attributes2) ) // new node, or its successors did not fit in the cache
+            a_attributes2 = getSuccessors(a_attributes, a_transactions, added, depth);
+
+        // the test of the tree of the last depth is explored first, so that the improvement of its subtrees bounds
+        // the other attributes
+        if ( trie->left(node) != NO_NODE ){
+            forEach (i, a_attributes2) {
+                if ( a_attributes2[i].second == trie->test(node) ){
+                    rotate(a_attributes2.elts, a_attributes2.elts + i, a_attributes2.elts + i + 1);
+                    break;
+                }
+            }
+        }
         //cout << "nb succ = " << a_attributes2.size << endl;
-        //((QueryData_Best*) node->data)->children = a_attributes2;
         //<===================  END STEP 4  ===================>
     }
 
     else {//case 2 : when the node exists but init value of upper bound is higher than the last one and last solution is NO_TREE
-        Error storedInit = ((QueryData_Best*) node->data)->initUb;
-        //initUb = min(parent_ub, ((QueryData_Best*) node->data)->leafError);
+        Error storedInit = trie->initUb(node);
+        //initUb = min(parent_ub, trie->leafError(node));
         initUb = parent_ub;
-        ((QueryData_Best*) node->data)->initUb = initUb;
-        Logger::showMessageAndReturn("noeud existant pour cette profondeur, sans solution avec nvelle init bound. leaf error = ", ((QueryData_Best*) node->data)->leafError, " last time: error = ", ((QueryData_Best*) node->data)->error, " and init = ", ((QueryData_Best*) node->data)->initUb, " and stored init = ", storedInit);
+        trie->initUb(node) = initUb;
+        Logger::showMessageAndReturn("noeud existant pour cette profondeur, sans solution avec nvelle init bound. leaf error = ", trie->leafError(node), " last time: error = ", trie->error(node), " and init = ", trie->initUb(node), " and stored init = ", storedInit);
 
 
         //IF TIMEOUT IS REACHED
         //<=================== START STEP 3 ===================>
         if ( query->timeLimitReached ){
-            if ( ((QueryData_Best*) node->data)->error == FLT_MAX )
-                ((QueryData_Best*) node->data)->error = ((QueryData_Best*) node->data)->leafError;
+            if ( trie->error(node) == noError<Error>() )
+                trie->error(node) = trie->leafError(node);
+            setSettled(node, false, currentMaxDepth);
             return node;
         }
 
@@ -217,13 +249,16 @@ TrieNode* LcmIterative::recurse ( Array<Item> itemset_,
 
         //ONLY STEP : determine successors
         //<=================== START STEP ===================>
-        //a_attributes2 = ((QueryData_Best*) node->data)->children;
-        a_attributes2 = getSuccessors(a_attributes, a_transactions, added);
+        a_attributes2 = buffers->successors(depth);
+        if ( !successorCache->find(node, a_attributes2) ) // the successors did not fit in the cache
+            a_attributes2 = getSuccessors(a_attributes, a_transactions, added, depth);
         //<===================  END STEP  ===================>
     }
 
 
     Error ub = initUb;
+    Error lastDepthError = noError<Error>(); // error of the tree found by the last iteration completed
+    bool improved = false; // whether the iteration at the root updated its tree
     do {
         if (depth == 0){
             Logger::showMessageAndReturn("======================================>");
@@ -231,37 +266,54 @@ TrieNode* LcmIterative::recurse ( Array<Item> itemset_,
         }
 
         int count = 0;
+        // whether the children explored did not depend on the depth, so that neither does the result of the node
+        bool settledChildren = true;
         forEach (i, a_attributes2) {
             if (a_attributes2[i].first) {
                 count++;
 
                 a_transactions->intersect(a_attributes2[i].second, false);
-                TrieNode *left = recurse(itemset, item(a_attributes2[i].second, 0), a_attributes2, a_transactions, depth + 1, ub,
+                Node left = recurse(itemset, item(a_attributes2[i].second, 0), a_attributes2, a_transactions, depth + 1, ub,
                                          currentMaxDepth);
                 a_transactions->backtrack();
+                settledChildren = settledChildren && settled(left);
 
-                if (query->canimprove(left->data, ub)) {
+                if (query->canimprove(left, ub)) {
 
-                    float remainUb = ub - ((QueryData_Best *) left->data)->error;
+                    Error remainUb = remainingBound(ub, trie->error(left));
                     a_transactions->intersect(a_attributes2[i].second);
-                    TrieNode *right = recurse(itemset, item(a_attributes2[i].second, 1), a_attributes2, a_transactions, depth + 1,
+                    Node right = recurse(itemset, item(a_attributes2[i].second, 1), a_attributes2, a_transactions, depth + 1,
                                               remainUb, currentMaxDepth);
                     a_transactions->backtrack();
+                    settledChildren = settledChildren && settled(right);
 
                     Error feature_error =
-                            ((QueryData_Best *) left->data)->error + ((QueryData_Best *) right->data)->error;
-                    bool hasUpdated = query->updateData(node->data, ub, a_attributes2[i].second, left->data,
-                                                        right->data);
+                            trie->error(left) + trie->error(right);
+                    bool hasUpdated = query->updateData(node, ub, a_attributes2[i].second, left,
+                                                        right);
                     if (hasUpdated) {
                         ub = feature_error;
+                        improved = true;
                         Logger::showMessageAndReturn("après cet attribut, node error = ",
-                                                     ((QueryData_Best *) node->data)->error, " et ub = ", ub);
+                                                     trie->error(node), " et ub = ", ub);
+                        if (depth == 0 && query->solution_callback != nullptr) {
+                            // the attributes left bound the error of the last depth only
+                            Error lowerBound = trie->lowerBound(node);
+                            if (currentMaxDepth == query->maxdepth)
+                                lowerBound = query->rootLowerBound(node, a_transactions, a_attributes2, i + 1,
+                                                                   currentMaxDepth == 1);
+                            if (query->publishSolution(node, lowerBound)) { // the caller is satisfied with this tree
+                                settledChildren = false;
+                                break;
+                            }
+                        }
                     }
 
-                    if (query->canSkip(node->data)) {//lowerBound
-                        //                    if (((QueryData_Best*) node->data )->lowerBound > 0)
-                        //                        cout << "lower = " << ((QueryData_Best*) node->data )->lowerBound << endl;
+                    if (query->canSkip(node)) {//lowerBound
+                        //                    if (trie->lowerBound(node) > 0)
+                        //                        cout << "lower = " << trie->lowerBound(node) << endl;
                         Logger::showMessageAndReturn("C'est le meilleur. on break le reste");
+                        settledChildren = true; // no depth improves a tree reaching the lower bound
                         break; //prune remaining attributes not browsed yet
                     }
                 }
@@ -270,50 +322,136 @@ TrieNode* LcmIterative::recurse ( Array<Item> itemset_,
         }
         if (count == 0) {
             Logger::showMessageAndReturn("pas d'enfant.");
-            if (parent_ub < ((QueryData_Best *) node->data)->leafError) {
-                ((QueryData_Best *) node->data)->error = FLT_MAX;
+            if (parent_ub < trie->leafError(node)) {
+                trie->error(node) = noError<Error>();
                 Logger::showMessageAndReturn("pas de solution");
             } else {
-                ((QueryData_Best *) node->data)->error = ((QueryData_Best *) node->data)->leafError;
-                Logger::showMessageAndReturn("on retourne leaf error = ", ((QueryData_Best *) node->data)->leafError);
+                trie->error(node) = trie->leafError(node);
+                Logger::showMessageAndReturn("on retourne leaf error = ", trie->leafError(node));
             }
             Logger::showMessageAndReturn("on replie");
         }
+        else if (lastTreeAboveBound && !improved && !query->timeLimitReached) {
+            // no tree better than the bound, but a larger one may still find a tree better than the last one
+            trie->error(node) = noError<Error>();
+        }
         Logger::showMessageAndReturn("depth = ", depth, " and init ub = ", initUb, " and error after search = ",
-                                     ((QueryData_Best *) node->data)->error);
+                                     trie->error(node));
+        // a node without frequent split, having no children, is a leaf whatever the depth
+        setSettled(node, settledChildren && !query->timeLimitReached, currentMaxDepth);
 
         if (depth == 0){
+            if ( query->timeLimitReached ){
+                // anytime answer: the tree of the last depth completed, unless the interrupted iteration improved it
+                if ( currentMaxDepth > 1 && !(trie->error(node) < ub) && ub == lastDepthError )
+                    restoreSolution(node, 0, currentMaxDepth - 1);
+                break;
+            }
             //cerr << "test" << endl;
             //cout << "\n\n===============================\n"
             //        "%%%%%%%%%%%% HERE %%%%%%%%%%%%%\n"
             //        "===============================" << endl;
-            Logger::showMessageAndReturn("Apres l'itération de la profondeur ", currentMaxDepth, ", l'erreur obtenue est : ", ((QueryData_Best *) node->data)->error);
+            Logger::showMessageAndReturn("Apres l'itération de la profondeur ", currentMaxDepth, ", l'erreur obtenue est : ", trie->error(node));
+            // an iteration which does not improve the tree keeps the one of the last iteration, whose nodes may
+            // have been searched again with this depth, so its result is the one printed after the last iteration
+            if (query->depthResults != nullptr) {
+                if (improved || query->depthResults->empty())
+                    query->depthResults->push_back(query->printResult(dataReader, node) + "LatticeSize: " + std::to_string(latticesize) + "\nRunTime: " + std::to_string(query->runTime()));
+                else
+                    query->depthResults->push_back(query->depthResults->back());
+            }
+            improved = false;
             currentMaxDepth += 1;
-            ub = ((QueryData_Best *) node->data)->error;
+            ub = lastDepthError = trie->error(node);
 
             if (currentMaxDepth == query->maxdepth && query->maxError > 0) //maxErrror is used as bound for the last iteration
-                ub = min(ub,query->maxError);
+                ub = min(ub, toError<Error>(query->maxError));
         }
     }while (depth == 0 && currentMaxDepth <= query->maxdepth);
 
-
-    a_attributes2.free();
-    if (itemset.size > 0)
-        itemset.free();
+    // the successors are kept while the node may be searched again, with a larger bound or a larger depth
+    if ( trie->error(node) <= trie->lowerBound(node) || ((currentMaxDepth >= query->maxdepth || settled(node)) && trie->error(node) < noError<Error>()) )
+        successorCache->release(node);
+    else
+        successorCache->store(node, a_attributes2);
 
     return node;
 }
 
 
-void LcmIterative::run () {
-    query->setStartTime(clock());
+template<class Query_>
+void LcmIterative<Query_>::saveSolution ( Node node, Depth depth ) {
+    if ( node >= solutions.size() )
+        solutions.resize(trie->getNNodes(), nullptr);
+    DepthSolution *&table = solutions[node];
+    if ( table == nullptr ){ // one solution for each remaining depth the node can be searched with
+        int nDepths = query->maxdepth - depth + 1;
+        table = (DepthSolution*) solutionArena.allocate(nDepths * sizeof(DepthSolution), alignof(DepthSolution));
+        for (int i = 0; i < nDepths; ++i)
+            table[i].size = 0;
+    }
+    DepthSolution &solution = table[trie->solutionDepth(node) - depth];
+    solution.error = trie->error(node);
+    solution.initUb = trie->initUb(node);
+    solution.left = trie->left(node);
+    solution.right = trie->right(node);
+    solution.test = trie->test(node);
+    solution.size = trie->size(node);
+}
+
+
+template<class Query_>
+void LcmIterative<Query_>::restoreSolution ( Node node, Depth depth, Depth maxDepth ) {
+    // the node has been searched again since, unless its solution was already settled then
+    bool settledThen = settled(node) && settledDepths[node] <= maxDepth;
+    if ( trie->solutionDepth(node) > maxDepth && !settledThen ){
+        DepthSolution *table = solutions[node];
+        int remaining = maxDepth - depth;
+        while ( table[remaining].size == 0 ) // solution of the last iteration which searched the node
+            --remaining;
+        DepthSolution &solution = table[remaining];
+        trie->error(node) = solution.error;
+        trie->initUb(node) = solution.initUb;
+        trie->left(node) = solution.left;
+        trie->right(node) = solution.right;
+        trie->test(node) = solution.test;
+        trie->size(node) = solution.size;
+        trie->setSolutionDepth(node, depth + remaining);
+    }
+    if ( trie->left(node) != NO_NODE ){
+        restoreSolution(trie->left(node), depth + 1, maxDepth);
+        restoreSolution(trie->right(node), depth + 1, maxDepth);
+    }
+}
+
+
+template<class Query_>
+void LcmIterative<Query_>::setSettled ( Node node, bool settled, Depth maxDepth ) {
+    if ( node >= settledDepths.size() ){
+        if ( !settled )
+            return;
+        settledDepths.resize(trie->getNNodes(), 0);
+    }
+    settledDepths[node] = settled ? (int16_t) maxDepth : 0;
+}
+
+
+template<class Query_>
+void LcmIterative<Query_>::run () {
+    query->setStartTime();
     Array<Item> itemset; //array of items representing an itemset
     itemset.size = 0;
-    Array<pair<bool, Attribute> > next_attributes(nattributes, 0);
+    Array<pair<bool, Attribute> > next_attributes(dataReader->getNAttributes(), 0);
 
     int sup[2];
-    RCover* cover = new RCover(dataReader);
-    for (int i = 0; i < nattributes; ++i) {
+    RCover* cover = new RCover(dataReader, query->trainingMask);
+    buffers = new SearchBuffers(min(query->maxdepth, dataReader->getNAttributes()), dataReader->getNAttributes(), dataReader->getNClasses());
+    successorCache = new SuccessorCache();
+    vector<Attribute> candidates = query->attributes; // all the attributes when none is given
+    if (candidates.empty())
+        for (int i = 0; i < dataReader->getNAttributes(); ++i)
+            candidates.push_back(i);
+    for (Attribute i : candidates) {
 
         cover->intersect(i, false);
         sup[0] = cover->getSupport();
@@ -327,18 +465,21 @@ void LcmIterative::run () {
             next_attributes.push_back(make_pair(true, i));
     }
 
-    float maxError = NO_ERR;
+    Error maxError = noError<Error>();
     if (query->maxError > 0)
-        maxError = query->maxError;
+        maxError = toError<Error>(query->maxError);
 
     query->realroot = recurse ( itemset, NO_ITEM, next_attributes, cover, 0, maxError, 1);
 
     next_attributes.free ();
+    delete buffers;
+    delete successorCache;
     delete cover;
 }
 
 
-float LcmIterative::informationGain ( pair<Supports,Support> notTaken, pair<Supports,Support> taken){
+template<class Query_>
+float LcmIterative<Query_>::informationGain ( pair<Supports,Support> notTaken, pair<Supports,Support> taken){
 
     int sumSupNotTaken = notTaken.second;
     int sumSupTaken = taken.second;
@@ -370,12 +511,15 @@ float LcmIterative::informationGain ( pair<Supports,Support> notTaken, pair<Supp
     //return condEntropy;
 }
 
-Array<pair<bool, Attribute> > LcmIterative::getSuccessors(Array<pair<bool, Attribute >> current_attributes,
+template<class Query_>
+Array<pair<bool, Attribute> > LcmIterative<Query_>::getSuccessors(Array<pair<bool, Attribute >> current_attributes,
                                                        RCover* current_cover,
-                                                       Item added) {
+                                                       Item added,
+                                                       Depth depth) {
 
-    std::multimap<float, pair<bool, Attribute> > gain;
-    Array<pair<bool, Attribute>> a_attributes2(current_attributes.size, 0);
+    vector<pair<pair<float, int>, pair<bool, Attribute>>>& gain = buffers->gains;
+    gain.clear();
+    Array<pair<bool, Attribute>> a_attributes2 = buffers->successors(depth);
     pair<Supports, Support> supports[2];
     map<int, unordered_set<int, Hash >> control;
     map<int, unordered_map<int, pair<int, float>, Hash>> controle;
@@ -399,11 +543,11 @@ Array<pair<bool, Attribute> > LcmIterative::getSuccessors(Array<pair<bool, Attri
             else{ // fast or default
 
                 current_cover->intersect(current_attributes[i].second, false);
-                supports[0] = current_cover->getSupportPerClass();
+                supports[0] = current_cover->getSupportPerClass(buffers->supports[0]);
                 current_cover->backtrack();
 
                 current_cover->intersect(current_attributes[i].second);
-                supports[1] = current_cover->getSupportPerClass();
+                supports[1] = current_cover->getSupportPerClass(buffers->supports[1]);
                 current_cover->backtrack();
             }
 
@@ -414,42 +558,38 @@ Array<pair<bool, Attribute> > LcmIterative::getSuccessors(Array<pair<bool, Attri
                     //when heuristic is used to reorder attribute, use a policy to always select the same attribute
                     if (infoGain) {
                         //attribute for this feature did not exist with these transactions
-                        if (controle[attrFeat[current_attributes[i].second]].count(supports[0].second) == 0)
-                            gain.insert(
-                                    std::pair<float, pair<bool, Attribute>>(informationGain(supports[0], supports[1]),
-                                            make_pair(true, current_attributes[i].second)));
+                        if (controle[dataReader->attrFeat[current_attributes[i].second]].count(supports[0].second) == 0)
+                            gain.push_back(make_pair(make_pair(informationGain(supports[0], supports[1]), int(gain.size())),
+                                                    make_pair(true, current_attributes[i].second)));
                         else
                             //attribute of this feature exist with these transactions and the existing attribute is the relevant (low index)
-                        if (controle[attrFeat[current_attributes[i].second]][supports[0].second].first <
+                        if (controle[dataReader->attrFeat[current_attributes[i].second]][supports[0].second].first <
                             current_attributes[i].second)
-                            gain.insert(std::pair<float, pair<bool, Attribute>>(
-                                    controle[attrFeat[current_attributes[i].second]][supports[0].second].second,
+                            gain.push_back(make_pair(make_pair(
+                                    controle[dataReader->attrFeat[current_attributes[i].second]][supports[0].second].second, int(gain.size())),
                                             make_pair(false, current_attributes[i].second)));
                         else {
                             //attribute of this feature exist with these transactions but this one is more relevant (low index)
-                            for (auto itr = gain.find(
-                                    controle[attrFeat[current_attributes[i].second]][supports[0].second].second);
-                                 itr != gain.end(); itr++)
-                                if (itr->second.second ==
-                                    controle[attrFeat[current_attributes[i].second]][supports[0].second].first) {
+                            for (auto itr = gain.begin(); itr != gain.end(); itr++)
+                                if (itr->first.first == controle[dataReader->attrFeat[current_attributes[i].second]][supports[0].second].second &&
+                                    itr->second.second == controle[dataReader->attrFeat[current_attributes[i].second]][supports[0].second].first) {
                                     itr->second.first = false;
-                                    gain.insert(std::pair<float, pair<bool, Attribute>>(itr->first, make_pair(true,
-                                                                                                              current_attributes[i].second)));
+                                    gain.push_back(make_pair(make_pair(itr->first.first, int(gain.size())), make_pair(true, current_attributes[i].second)));
                                     break;
                                 }
                         }
                     } else { //when there is not heuristic
 
-                        int sizeBefore = int(control[attrFeat[current_attributes[i].second]].size());
-                        control[attrFeat[current_attributes[i].second]].insert(supports[0].second);
-                        int sizeAfter = int(control[attrFeat[current_attributes[i].second]].size());
+                        int sizeBefore = int(control[dataReader->attrFeat[current_attributes[i].second]].size());
+                        control[dataReader->attrFeat[current_attributes[i].second]].insert(supports[0].second);
+                        int sizeAfter = int(control[dataReader->attrFeat[current_attributes[i].second]].size());
 
                         a_attributes2.push_back(make_pair(sizeAfter != sizeBefore, current_attributes[i].second));
                     }
                 } else {
 
                     if (infoGain)
-                        gain.insert(std::pair<float, pair<bool, Attribute>>(informationGain(supports[0], supports[1]),
+                        gain.push_back(make_pair(make_pair(informationGain(supports[0], supports[1]), int(gain.size())),
                                 make_pair(true, current_attributes[i].second)));
                     else a_attributes2.push_back(make_pair(true, current_attributes[i].second));
 
@@ -457,49 +597,40 @@ Array<pair<bool, Attribute> > LcmIterative::getSuccessors(Array<pair<bool, Attri
 
             } else {
                 if (infoGain)
-                    gain.insert(std::pair<float, pair<bool, Attribute>>(NO_GAIN, make_pair(false,
+                    gain.push_back(make_pair(make_pair(NO_GAIN, int(gain.size())), make_pair(false,
                                                                                            current_attributes[i].second)));
                 else a_attributes2.push_back(make_pair(false, current_attributes[i].second));
             }
 
         } else {
             if (infoGain)
-                gain.insert(
-                        std::pair<float, pair<bool, Attribute>>(NO_GAIN, make_pair(false, current_attributes[i].second)));
+                gain.push_back(
+                        make_pair(make_pair(NO_GAIN, int(gain.size())), make_pair(false, current_attributes[i].second)));
             else a_attributes2.push_back(current_attributes[i]);
         }
     }
 
 
-    if (infoGain) {
-        if (infoAsc) { //items with low IG first
-            multimap<float, pair<bool, int>>::iterator it;
-            for (it = gain.begin(); it != gain.end(); ++it) {
-                a_attributes2.push_back(it->second);
-            }
-        } else { //items with high IG first
-            multimap<float, pair<bool, int>>::reverse_iterator it;
-            for (it = gain.rbegin(); it != gain.rend(); ++it) {
-                a_attributes2.push_back(it->second);
-            }
-        }
-
-    }
+    if (infoGain) //if infoAsc, items with low IG first. Otherwise, items with high IG first
+        buffers->sortByGain(a_attributes2, infoAsc);
     if (!allDepths)
         infoGain = false;
 
-    deleteSupports(supports[0].first);
-    deleteSupports(supports[1].first);
-
     return a_attributes2;
 
 }
 
-void LcmIterative::printItemset(Array<Item> itemset){
-    if (verbose){
+template<class Query_>
+void LcmIterative<Query_>::printItemset(Array<Item> itemset){
+    if (Logger::enable){
         for (int i = 0; i < itemset.size; ++i) {
             cout << itemset[i] << ",";
         }
         cout << endl;
     }
-}
\ No newline at end of file
+}
+
+template class LcmIterative<Query_TotalFreq<MisclassificationError>>;
+template class LcmIterative<Query_TotalFreq<PluginError>>;
+template class LcmIterative<Query_TotalFreq<WeightedError>>;
+template class LcmIterative<Query_TotalFreq<CallbackError>>;
@@ -1,10 +1,11 @@
 #include "lcm_pruned.h"
-#include "query_best.h" // if cannot link is specified, we need a clustering problem!!!
+#include "query_totalfreq.h"
 #include "logger.h"
 #include <iostream>
 #include <limits.h>
 #include <cassert>
 #include <cmath>
+#include <algorithm>
 #include <map>
 #include <unordered_set>
 #include <unordered_map>
@@ -17,31 +18,44 @@ struct Hash {
     }
 };
 
-LcmPruned::LcmPruned(DataManager *dataReader, Query *query, Trie *trie, bool infoGain, bool infoAsc, bool allDepths) :
+template<class Query_>
+LcmPruned<Query_>::LcmPruned(DataManager *dataReader, Query_ *query, Trie<Error> *trie, bool infoGain, bool infoAsc, bool allDepths) :
         dataReader(dataReader), query(query), trie(trie), infoGain(infoGain), infoAsc(infoAsc), allDepths(allDepths) {
 }
 
-LcmPruned::~LcmPruned() {
+template<class Query_>
+LcmPruned<Query_>::~LcmPruned() {
+    rootAttributes.free();
+    delete[] frames;
+    delete buffers;
+    delete successorCache;
+    delete cover;
 }
 
-TrieNode *LcmPruned::recurse(Array<Item> itemset_,
-                             Item added,
-                             Array<pair<bool, Attribute> > current_attributes,
-                             RCover* current_cover,
-                             Depth depth,
-                             float parent_ub) {
+template<class Query_>
+void LcmPruned<Query_>::open(Depth depth, Item added, Error parent_ub) {
 
     // std::cout << "TESTING STUFFF" << std::endl;
     if (query->timeLimit > 0) {
-        float runtime = (clock() - query->startTime) / (float) CLOCKS_PER_SEC;
-        if (runtime >= query->timeLimit)
+        if (query->runTime() >= query->timeLimit)
             query->timeLimitReached = true;
     }
 
-    Array<Item> itemset;
+    Array<Item> itemset_, itemset;
+    Array<pair<bool, Attribute> > current_attributes;
+    if (depth == 0) {
+        itemset_.size = 0;
+        itemset_.elts = nullptr;
+        current_attributes = rootAttributes;
+    }
+    else {
+        itemset_ = frames[depth - 1].itemset;
+        current_attributes = frames[depth - 1].attributes;
+    }
 
     if (added != NO_ITEM){
-        itemset.alloc(itemset_.size + 1);
+        itemset = buffers->itemset(depth);
+        itemset.resize(itemset_.size + 1);
         addItem(itemset_, added, itemset);
     }
     else{
@@ -56,127 +70,171 @@ TrieNode *LcmPruned::recurse(Array<Item> itemset_,
     printItemset(itemset);
 
     //insert the node in the cache or get it if it already exists
-    TrieNode *node = trie->insert(itemset);
+    Node node = trie->insert(itemset);
+    returned = node;
+
+    int warm = -1;
+    if (!warmNodes.empty()) {
+        if (depth == 0)
+            warm = 0;
+        else if (frames[depth - 1].warm >= 0 && warmNodes[frames[depth - 1].warm].test == item_attribute(added)) {
+            const WarmNode &parent = warmNodes[frames[depth - 1].warm];
+            warm = item_value(added) ? parent.positive : parent.negative;
+        }
+    }
+
+    // a node solved by the search of a smaller depth, whose cache is reused, is searched again with its tree as bound,
+    // unless this tree reaches the lower bound
+    bool stale = trie->hasData(node) && depth < query->maxdepth && trie->solutionDepth(node) < query->maxdepth;
+    if (stale && (trie->leafError(node) <= trie->lowerBound(node) || trie->error(node) <= trie->lowerBound(node))) {
+        trie->setSolutionDepth(node, query->maxdepth);
+        return;
+    }
 
-    if (node->data) {//node already exists
+    if (trie->hasData(node) && !stale) {//node already exists
         Logger::showMessageAndReturn("le noeud exists");
 
-        Error leafError = ((QueryData_Best *) node->data)->leafError;
-        Error lower_bound = ( (QueryData_Best*) node->data )->lowerBound;
-        Error *nodeError = &(((QueryData_Best *) node->data)->error);
-        Error storedInitUb = ((QueryData_Best *) node->data)->initUb;
+        Error leafError = trie->leafError(node);
+        Error lower_bound = trie->lowerBound(node);
+        Error *nodeError = &(trie->error(node));
+        Error storedInitUb = trie->initUb(node);
         Error initUb = parent_ub;
 
-        if (*nodeError < FLT_MAX) { //if( nodeError != FLT_MAX ) best solution has been already found
+        if (*nodeError < noError<Error>()) { //if( nodeError != noError<Error>() ) best solution has been already found
             Logger::showMessageAndReturn("solution avait été trouvée et vaut : ", *nodeError);
-            itemset.free();
-            return node;
+            return;
         }
 
-        if (!nps)
+        if (!query->nps)
             if (initUb <= storedInitUb) { //solution has not been found last time but the result is the same for this time
                 Logger::showMessageAndReturn("y'avait pas de solution mais c'est pareil cette fois-ci. Ancien init =", storedInitUb, " et nouveau = ", initUb);
-                itemset.free();
-                return node;
+                    return;
             }
 
         if (leafError <= lower_bound) { // if we have a node already visited with lErr = 0, we can return the last solution
             Logger::showMessageAndReturn("l'erreur est nulle");
-            itemset.free();
-            return node;
+            return;
         }
 
         if (depth == query->maxdepth) {
             Logger::showMessageAndReturn("on a atteint la profondeur maximale. parent boud = ", parent_ub, " et leaf error = ", leafError);
 
             if (parent_ub <= leafError) {
-                *nodeError = FLT_MAX;
+                *nodeError = noError<Error>();
                 Logger::showMessageAndReturn("pas de solution");
             } else {
                 *nodeError = leafError;
                 Logger::showMessageAndReturn("on retourne leaf error = ", leafError);
             }
-            itemset.free();
-            return node;
+            return;
         }
     }
 
-    //there are two cases in which the execution attempt here
+    //there are three cases in which the execution attempt here
     //1- when the node did not exist
     //2- when the node exists but init value of upper bound is higher than the last one and last solution is NO_TREE
+    //3- when the node was solved for a smaller depth
 
 
     Array<pair<bool, Attribute> > next_attributes;
-    Error initUb = FLT_MAX;
+    Error initUb = noError<Error>();
+    // whether the tree of the smaller depth is worse than the bound given by the parent. It is not a solution unless
+    // the search improves it
+    bool lastTreeAboveBound = false;
 
 
-    if (!node->data) { // case 1 : when the node did not exist
+    if (!trie->hasData(node)) { // case 1 : when the node did not exist
         Logger::showMessageAndReturn("Nouveau noeud");
         latticesize++;
         //if ( closedsize % 1000 == 0 )
         //cerr << "--- Searching, lattice size: " << latticesize << "\r" << flush;
 
         //<=================== STEP 1 : Initialize all information about the node ===================>
-        node->data = query->initData(current_cover, parent_ub, query->minsup);
+        query->initData(node, cover, parent_ub, query->maxdepth);
         //get the upper bound. it will be used for children in for loop
-        initUb = ((QueryData_Best *) node->data)->initUb;
-        Logger::showMessageAndReturn("après initialisation du nouveau noeud. parent bound = ", parent_ub," et leaf error = ", ((QueryData_Best *) node->data)->leafError, " init bound = ", initUb);
+        initUb = trie->initUb(node);
+        Logger::showMessageAndReturn("après initialisation du nouveau noeud. parent bound = ", parent_ub," et leaf error = ", trie->leafError(node), " init bound = ", initUb);
         //<====================================  END STEP  ==========================================>
 
 
 
         //<====================== STEP 2 : Case in which we cannot split more =======================>
-        if (((QueryData_Best *) node->data)->leafError <= ((QueryData_Best *) node->data)->lowerBound) {
+        if (trie->leafError(node) <= trie->lowerBound(node)) {
             //when leaf error equals 0 all solution parameters have already been stored by initData apart from node error
-            ((QueryData_Best *) node->data)->error = ((QueryData_Best *) node->data)->leafError;
-            Logger::showMessageAndReturn("l'erreur est nulle. node error = leaf error = ", ((QueryData_Best *) node->data)->error);
-            itemset.free();
-            return node;
+            trie->error(node) = trie->leafError(node);
+            Logger::showMessageAndReturn("l'erreur est nulle. node error = leaf error = ", trie->error(node));
+            return;
         }
 
         if (depth == query->maxdepth) {
-            Logger::showMessageAndReturn("on a atteint la profondeur maximale. parent boud = ", parent_ub, " et leaf error = ", ((QueryData_Best *) node->data)->leafError);
-            if ( ((QueryData_Best *) node->data)->leafError < parent_ub ) {
-                ((QueryData_Best *) node->data)->error = ((QueryData_Best *) node->data)->leafError;
-                Logger::showMessageAndReturn("on retourne leaf error = ", ((QueryData_Best *) node->data)->leafError);
+            Logger::showMessageAndReturn("on a atteint la profondeur maximale. parent boud = ", parent_ub, " et leaf error = ", trie->leafError(node));
+            if ( trie->leafError(node) < parent_ub ) {
+                trie->error(node) = trie->leafError(node);
+                Logger::showMessageAndReturn("on retourne leaf error = ", trie->leafError(node));
             } else {
-                ((QueryData_Best *) node->data)->error = FLT_MAX;
+                trie->error(node) = noError<Error>();
                 Logger::showMessageAndReturn("pas de solution");
             }
-            itemset.free();
-            return node;
+            return;
         }
 
         if (query->timeLimitReached) {
-            ((QueryData_Best *) node->data)->error = ((QueryData_Best *) node->data)->leafError;
-            itemset.free();
-            return node;
+            trie->error(node) = trie->leafError(node);
+            return;
         }
+
+        // so does the subtree of the prior tree on the path of the node
+        if (warm > 0 && useGreedyBound() && warmNodes[warm].error < noError<Error>() && boundAbove(warmNodes[warm].error) < initUb)
+            initUb = boundAbove(warmNodes[warm].error);
         //<====================================  END STEP  ==========================================>
 
 
 
         //<============================= STEP 3 : determine successors ==============================>
-        next_attributes = getSuccessors(current_attributes, current_cover, added);
+        next_attributes = getSuccessors(current_attributes, cover, added, depth);
         //<====================================  END STEP  ==========================================>
 
     }
+    else if (stale) {//case 3 : the tree of the smaller depth is a tree of this depth, which bounds the search
+        lastTreeAboveBound = parent_ub < trie->error(node);
+        initUb = min(parent_ub, trie->error(node));
+        trie->initUb(node) = initUb;
+        trie->setSolutionDepth(node, query->maxdepth);
+
+        if (query->timeLimitReached) {
+            if (trie->error(node) == noError<Error>())
+                trie->error(node) = trie->leafError(node);
+            return;
+        }
+
+        next_attributes = getSuccessors(current_attributes, cover, added, depth);
+
+        // its test is explored first, so that the improvement of its subtrees bounds the other attributes
+        if (trie->left(node) != NO_NODE) {
+            forEach (i, next_attributes) {
+                if (next_attributes[i].second == trie->test(node)) {
+                    rotate(next_attributes.elts, next_attributes.elts + i, next_attributes.elts + i + 1);
+                    break;
+                }
+            }
+        }
+    }
     else {//case 2 : when the node exists but init value of upper bound is higher than the last one and last solution were NO_TREE
-        Error storedInit = ((QueryData_Best *) node->data)->initUb;
+        Error storedInit = trie->initUb(node);
         initUb = parent_ub;
-        ((QueryData_Best *) node->data)->initUb = initUb;
-        Logger::showMessageAndReturn("noeud existant sans solution avec nvelle init bound. leaf error = ", ((QueryData_Best *) node->data)->leafError, " last time: error = ", ((QueryData_Best *) node->data)->error, " and init = ", ((QueryData_Best *) node->data)->initUb, " and stored init = ", storedInit);
+        trie->initUb(node) = initUb;
+        Logger::showMessageAndReturn("noeud existant sans solution avec nvelle init bound. leaf error = ", trie->leafError(node), " last time: error = ", trie->error(node), " and init = ", trie->initUb(node), " and stored init = ", storedInit);
 
         if (query->timeLimitReached) {
-            if (((QueryData_Best *) node->data)->error == FLT_MAX)
-                ((QueryData_Best *) node->data)->error = ((QueryData_Best *) node->data)->leafError;
-            itemset.free();
-            return node;
+            if (trie->error(node) == noError<Error>())
+                trie->error(node) = trie->leafError(node);
+            return;
         }
 
         //<=========================== ONLY STEP : determine successors =============================>
-        next_attributes = getSuccessors(current_attributes, current_cover, added);
-        // next_attributes = (QueryData_Best *) node->data)->successors //if successors have been cached
+        next_attributes = buffers->successors(depth);
+        if (!successorCache->find(node, next_attributes)) // the successors did not fit in the cache
+            next_attributes = getSuccessors(current_attributes, cover, added, depth);
         // Array<pair<bool, Attribute>> no_attributes = getExistingSuccessors(node); //get successors from trie
         /*if (next_attributes.size != no_attributes.size){ //print for debug
             cout << "itemset size : " << itemset.size << endl;
@@ -194,84 +252,173 @@ TrieNode *LcmPruned::recurse(Array<Item> itemset_,
         //<====================================  END STEP  ==========================================>
     }
 
+    // the test of the prior tree is explored first, so that its subtree bounds the other attributes
+    if (warm >= 0 && warmNodes[warm].test >= 0) {
+        forEach (i, next_attributes) {
+            if (next_attributes[i].second == warmNodes[warm].test && next_attributes[i].first) {
+                rotate(next_attributes.elts, next_attributes.elts + i, next_attributes.elts + i + 1);
+                break;
+            }
+        }
+    }
 
-    Error ub = initUb;
-    int count = 0;
-    forEach (i, next_attributes) {
-        if (next_attributes[i].first) {
-            count++;
+    // the children of the node are explored from the frame pushed for it
+    Frame &frame = frames[depth];
+    frame.node = node;
+    frame.itemset = itemset;
+    frame.attributes = next_attributes;
+    frame.i = 0;
+    frame.count = 0;
+    frame.ub = initUb;
+    frame.initUb = initUb;
+    frame.parentUb = parent_ub;
+    frame.left = NO_NODE;
+    frame.state = NEXT_ATTRIBUTE;
+    frame.warm = warm;
+    frame.lastTreeAboveBound = lastTreeAboveBound;
+    top = depth;
+}
 
-            current_cover->intersect(next_attributes[i].second, false);
-            TrieNode *left = recurse(itemset, item(next_attributes[i].second, 0), next_attributes, current_cover, depth + 1, ub);
-            current_cover->backtrack();
 
-            if (query->canimprove(left->data, ub)) {
+template<class Query_>
+void LcmPruned<Query_>::close(Frame &frame, Depth depth) {
+    Node node = frame.node;
+    if (frame.count == 0) {
+        Logger::showMessageAndReturn("pas d'enfant.");
+        if ( trie->leafError(node) < frame.parentUb ) {
+            trie->error(node) = trie->leafError(node);
+            Logger::showMessageAndReturn("on retourne leaf error = ", trie->leafError(node));
+        } else {
+            trie->error(node) = noError<Error>();
+            Logger::showMessageAndReturn("pas de solution");
+        }
+        Logger::showMessageAndReturn("on replie");
+    }
+    else if (frame.lastTreeAboveBound && frame.parentUb <= trie->error(node)) // the tree of the smaller depth was kept
+        trie->error(node) = noError<Error>();
+    if (trie->error(node) == noError<Error>()) //cache successors if solution not found
+        successorCache->store(node, frame.attributes);
+    else //free the cache when solution found
+        successorCache->release(node);
+    Logger::showMessageAndReturn("depth = ", depth, " and init ub = ", frame.initUb, " and error after search = ", trie->error(node));
+
+    returned = node;
+    top = depth - 1;
+}
 
-                float remainUb = ub - ((QueryData_Best *) left->data)->error;
-                current_cover->intersect(next_attributes[i].second);
-                TrieNode *right = recurse(itemset, item(next_attributes[i].second, 1), next_attributes, current_cover, depth + 1, remainUb);
-                current_cover->backtrack();
 
-                Error feature_error = ((QueryData_Best *) left->data)->error + ((QueryData_Best *) right->data)->error;
-                bool hasUpdated = query->updateData(node->data, ub, next_attributes[i].second, left->data, right->data);
+template<class Query_>
+bool LcmPruned<Query_>::resume(long maxSteps) {
+    // each step moves the top frame to its next state. A child is explored by pushing its frame above, and the result
+    // of the child is read from returned when the frame is on top again
+    for (; top >= 0 && maxSteps != 0; --maxSteps) {
+        Depth depth = top;
+        Frame &frame = frames[depth];
+        Attribute attribute = frame.i < frame.attributes.size ? frame.attributes[frame.i].second : -1;
+
+        switch (frame.state) {
+            case NEXT_ATTRIBUTE:
+                if (frame.i == frame.attributes.size) {
+                    close(frame, depth);
+                    break;
+                }
+                if (!frame.attributes[frame.i].first ||
+                    (depth == 0 && !query->rootTests.empty() && !query->rootTests[attribute])) {
+                    frame.state = ATTRIBUTE_EXPLORED;
+                    break;
+                }
+                if (depth == 0 && query->rootBound != nullptr) { // only the trees better than the other searches matter
+                    float bound = (*query->rootBound)();
+                    if (bound < NO_ERR && toError<Error>(bound) < frame.ub)
+                        frame.ub = toError<Error>(bound);
+                }
+                frame.count++;
+                frame.state = LEFT_EXPLORED;
+                cover->intersect(attribute, false);
+                open(depth + 1, item(attribute, 0), frame.ub);
+                break;
+
+            case LEFT_EXPLORED:
+                cover->backtrack();
+                frame.left = returned;
+                if (query->canimprove(frame.left, frame.ub)) {
+                    Error remainUb = remainingBound(frame.ub, trie->error(frame.left));
+                    frame.state = RIGHT_EXPLORED;
+                    cover->intersect(attribute);
+                    open(depth + 1, item(attribute, 1), remainUb);
+                }
+                else
+                    frame.state = ATTRIBUTE_EXPLORED;
+                break;
+
+            case RIGHT_EXPLORED: {
+                cover->backtrack();
+                Node right = returned;
+                Error feature_error = trie->error(frame.left) + trie->error(right);
+                bool hasUpdated = query->updateData(frame.node, frame.ub, attribute, frame.left, right);
                 if (hasUpdated) {
-                    ub = feature_error;
-                    Logger::showMessageAndReturn("après cet attribut, node error = ", ((QueryData_Best *) node->data)->error, " et ub = ", ub);
+                    frame.ub = feature_error;
+                    Logger::showMessageAndReturn("après cet attribut, node error = ", trie->error(frame.node), " et ub = ", frame.ub);
+                    if (depth == 0 && query->solution_callback != nullptr) {
+                        Error lowerBound = query->rootLowerBound(frame.node, cover, frame.attributes, frame.i + 1,
+                                                                 query->maxdepth == 1);
+                        if (query->publishSolution(frame.node, lowerBound)) { // the caller is satisfied with this tree
+                            close(frame, depth);
+                            break;
+                        }
+                    }
                 }
 
-                if (query->canSkip(node->data)) {//lowerBound reached
+                if (query->canSkip(frame.node)) {//lowerBound reached
                     Logger::showMessageAndReturn("C'est le meilleur. on break le reste");
-                    break; //prune remaining attributes not browsed yet
+                    close(frame, depth); //prune remaining attributes not browsed yet
+                    break;
                 }
+                frame.state = ATTRIBUTE_EXPLORED;
+                break;
             }
 
+            case ATTRIBUTE_EXPLORED:
+                if (query->stopAfterError){
+                    if (depth == 0 && frame.parentUb < noError<Error>()){
+                        if ( trie->error(frame.node) < frame.parentUb ) {
+                            close(frame, depth);
+                            break;
+                        }
+                    }
+                }
+                frame.i++;
+                frame.state = NEXT_ATTRIBUTE;
+                break;
         }
-
-        if (query->stopAfterError){
-            if (depth == 0 && parent_ub < FLT_MAX){
-                if ( ( (QueryData_Best*) node->data )->error < parent_ub )
-                    break;
-            }
-        }
-    }
-    /*if ((QueryData_Best *) node->data)->error == FLT_MAX) //cache successors if solution not found
-        (QueryData_Best *) node->data)->successors = next_attributes;
-    else{ //free the cache when solution found
-        if ((QueryData_Best *) node->data)->successors != nullptr)
-        (QueryData_Best *) node->data)->successors = nullptr;
-    }*/
-
-    if (count == 0) {
-        Logger::showMessageAndReturn("pas d'enfant.");
-        if ( ((QueryData_Best *) node->data)->leafError < parent_ub ) {
-            ((QueryData_Best *) node->data)->error = ((QueryData_Best *) node->data)->leafError;
-            Logger::showMessageAndReturn("on retourne leaf error = ", ((QueryData_Best *) node->data)->leafError);
-        } else {
-            ((QueryData_Best *) node->data)->error = FLT_MAX;
-            Logger::showMessageAndReturn("pas de solution");
-        }
-        Logger::showMessageAndReturn("on replie");
     }
-    Logger::showMessageAndReturn("depth = ", depth, " and init ub = ", initUb, " and error after search = ", ((QueryData_Best *) node->data)->error);
-
+    return top < 0;
+}
 
-    next_attributes.free();
-    itemset.free();
 
-    return node;
+template<class Query_>
+vector<Node> LcmPruned<Query_>::pendingNodes() const {
+    vector<Node> nodes;
+    for (int depth = 0; depth <= top; ++depth)
+        nodes.push_back(frames[depth].node);
+    return nodes;
 }
 
 
-void LcmPruned::run() {
-    query->setStartTime(clock());
-    Array<Item> itemset; //array of items representing an itemset
-    itemset.size = 0;
-    Array<pair<bool, Attribute> > next_attributes(nattributes, 0);
+template<class Query_>
+void LcmPruned<Query_>::start() {
+    query->setStartTime();
+    rootAttributes = Array<pair<bool, Attribute> >(dataReader->getNAttributes(), 0);
 
     //int sup[2];
-    RCover* cover = new RCover(dataReader);
-    for (int i = 0; i < nattributes; ++i) {
-        next_attributes.push_back(make_pair(true, i));
+    cover = new RCover(dataReader, query->trainingMask);
+    Depth maxDepth = min(query->maxdepth, dataReader->getNAttributes());
+    buffers = new SearchBuffers(maxDepth, dataReader->getNAttributes(), dataReader->getNClasses());
+    frames = new Frame[maxDepth + 1];
+    successorCache = new SuccessorCache();
+    for (int i = 0; i < dataReader->getNAttributes(); ++i) {
+        if (query->attributes.empty())
+            rootAttributes.push_back(make_pair(true, i));
 
         /*cover->intersect(i, false);
         sup[0] = cover->getSupport();
@@ -282,21 +429,141 @@ void LcmPruned::run() {
         cover->backtrack();
 
         if (sup[0] >= query->minsup && sup[1] >= query->minsup)
-            next_attributes.push_back(make_pair(true, i));*/
+            rootAttributes.push_back(make_pair(true, i));*/
     }
+    for (Attribute attribute : query->attributes)
+        rootAttributes.push_back(make_pair(true, attribute));
 
-    float maxError = NO_ERR;
+    Error maxError = noError<Error>();
     if (query->maxError > 0)
-        maxError = query->maxError;
+        maxError = toError<Error>(query->maxError);
+    // the greedy tree and the prior tree prune the first branches, which would otherwise be explored without bound.
+    // Their bounds are not used when the search stops at the first tree better than maxError, which they would delay.
+    // For the other error functions, the prior tree only orders the tests. The greedy trees of the inner nodes would
+    // only cut a few more nodes, for the time of their own building
+    Error firstTreeError = noError<Error>();
+    if (!query->warmTree.empty()) {
+        size_t pos = 0;
+        readWarmTree(pos);
+        if (useGreedyBound())
+            firstTreeError = warmError(0, 0);
+    }
+    if (useGreedyBound())
+        firstTreeError = min(firstTreeError, greedyError(0));
+    if (firstTreeError < noError<Error>() && !query->stopAfterError && boundAbove(firstTreeError) < maxError)
+        maxError = boundAbove(firstTreeError);
 
-    query->realroot = recurse(itemset, NO_ITEM, next_attributes, cover, 0, maxError);
+    open(0, NO_ITEM, maxError);
+    query->realroot = returned;
+}
 
-    next_attributes.free();
-    delete cover;
+
+template<class Query_>
+typename LcmPruned<Query_>::Error LcmPruned<Query_>::greedyError(Depth depth) {
+    Error lowerBound = 0;
+    Error leafError = query->leafError(cover, &lowerBound);
+    if (depth == query->maxdepth || leafError <= lowerBound)
+        return leafError;
+
+    // an attribute already tested gives an empty branch, which is not frequent
+    Attribute best = -1;
+    float bestGain = 0;
+    Error bestError = leafError;
+    forEach (i, rootAttributes) {
+        Attribute attribute = rootAttributes[i].second;
+        pair<Supports, Support> supports[2];
+        cover->intersect(attribute, false);
+        supports[0] = cover->getSupportPerClass(buffers->supports[0]);
+        Error error = (depth + 1 == query->maxdepth) ? query->leafError(cover, &lowerBound) : 0;
+        cover->backtrack();
+        cover->intersect(attribute);
+        supports[1] = cover->getSupportPerClass(buffers->supports[1]);
+        if (depth + 1 == query->maxdepth)
+            error += query->leafError(cover, &lowerBound);
+        cover->backtrack();
+        if (!query->is_freq(supports[0]) || !query->is_freq(supports[1]))
+            continue;
+
+        if (depth + 1 == query->maxdepth) { // the last split is the best one
+            if (error < bestError) {
+                best = attribute;
+                bestError = error;
+            }
+        }
+        else {
+            float gain = informationGain(supports[0], supports[1]);
+            if (best == -1 || gain > bestGain) {
+                best = attribute;
+                bestGain = gain;
+            }
+        }
+    }
+    if (best == -1)
+        return leafError;
+    if (depth + 1 == query->maxdepth)
+        return bestError;
+
+    cover->intersect(best, false);
+    Error error = greedyError(depth + 1);
+    cover->backtrack();
+    cover->intersect(best);
+    error += greedyError(depth + 1);
+    cover->backtrack();
+    return min(leafError, error);
 }
 
 
-float LcmPruned::informationGain(pair<Supports, Support> notTaken, pair<Supports, Support> taken) {
+template<class Query_>
+int LcmPruned<Query_>::readWarmTree(size_t &pos) {
+    int index = (int) warmNodes.size();
+    Attribute test = (pos < query->warmTree.size()) ? query->warmTree[pos++] : -1;
+    // a test on an attribute missing from these data or out of the candidates is cut, its subtrees being read and
+    // dropped
+    bool candidate = test < dataReader->getNAttributes() && (query->attributes.empty() ||
+            find(query->attributes.begin(), query->attributes.end(), test) != query->attributes.end());
+    WarmNode node = {candidate ? test : -1, -1, -1, noError<Error>()};
+    warmNodes.push_back(node);
+    if (test >= 0) {
+        int positive = readWarmTree(pos);
+        int negative = readWarmTree(pos);
+        warmNodes[index].positive = positive;
+        warmNodes[index].negative = negative;
+    }
+    return index;
+}
+
+
+template<class Query_>
+typename LcmPruned<Query_>::Error LcmPruned<Query_>::warmError(int warm, Depth depth) {
+    Error lowerBound = 0;
+    Error error = query->leafError(cover, &lowerBound);
+    WarmNode node = warmNodes[warm];
+    if (node.test >= 0 && depth < query->maxdepth) {
+        cover->intersect(node.test, false);
+        bool frequent = cover->getSupport() >= query->minsup;
+        Error negative = warmError(node.negative, depth + 1);
+        cover->backtrack();
+        cover->intersect(node.test);
+        frequent = frequent && cover->getSupport() >= query->minsup;
+        Error positive = warmError(node.positive, depth + 1);
+        cover->backtrack();
+        if (frequent && positive + negative < error)
+            error = positive + negative;
+    }
+    warmNodes[warm].error = error;
+    return error;
+}
+
+
+template<class Query_>
+void LcmPruned<Query_>::run() {
+    start();
+    resume();
+}
+
+
+template<class Query_>
+float LcmPruned<Query_>::informationGain(pair<Supports, Support> notTaken, pair<Supports, Support> taken) {
 
     int sumSupNotTaken = notTaken.second;
     int sumSupTaken = taken.second;
@@ -328,16 +595,18 @@ float LcmPruned::informationGain(pair<Supports, Support> notTaken, pair<Supports
 }
 
 
-Array<pair<bool, Attribute> > LcmPruned::getSuccessors(Array<pair<bool, Attribute >> current_attributes,
+template<class Query_>
+Array<pair<bool, Attribute> > LcmPruned<Query_>::getSuccessors(Array<pair<bool, Attribute >> current_attributes,
                                                        RCover* current_cover,
-                                                       Item added) {
+                                                       Item added,
+                                                       Depth depth) {
 
-    std::multimap<float, pair<bool, Attribute> > gain;
-    Array<pair<bool, Attribute>> a_attributes2(current_attributes.size, 0);
+    vector<pair<pair<float, int>, pair<bool, Attribute>>>& gain = buffers->gains;
+    gain.clear();
+    Array<pair<bool, Attribute>> a_attributes2 = buffers->successors(depth);
     pair<Supports, Support> supports[2];
     map<int, unordered_set<int, Hash >> control;
     map<int, unordered_map<int, pair<int, float>, Hash>> controle;
-    bool to_delete = false;
 
     forEach (i, current_attributes) {
         if (item_attribute (added) == current_attributes[i].second)
@@ -357,13 +626,12 @@ Array<pair<bool, Attribute> > LcmPruned::getSuccessors(Array<pair<bool, Attribut
             }
             else{ // fast or default
 
-                to_delete = true;
                 current_cover->intersect(current_attributes[i].second, false);
-                supports[0] = current_cover->getSupportPerClass();
+                supports[0] = current_cover->getSupportPerClass(buffers->supports[0]);
                 current_cover->backtrack();
 
                 current_cover->intersect(current_attributes[i].second);
-                supports[1] = current_cover->getSupportPerClass();
+                supports[1] = current_cover->getSupportPerClass(buffers->supports[1]);
                 current_cover->backtrack();
             }
 
@@ -374,42 +642,38 @@ Array<pair<bool, Attribute> > LcmPruned::getSuccessors(Array<pair<bool, Attribut
                     //when heuristic is used to reorder attribute, use a policy to always select the same attribute
                     if (infoGain) {
                         //attribute for this feature did not exist with these transactions
-                        if (controle[attrFeat[current_attributes[i].second]].count(supports[0].second) == 0)
-                            gain.insert(
-                                    std::pair<float, pair<bool, Attribute>>(informationGain(supports[0], supports[1]),
-                                            make_pair(true, current_attributes[i].second)));
+                        if (controle[dataReader->attrFeat[current_attributes[i].second]].count(supports[0].second) == 0)
+                            gain.push_back(make_pair(make_pair(informationGain(supports[0], supports[1]), int(gain.size())),
+                                                    make_pair(true, current_attributes[i].second)));
                         else
                             //attribute of this feature exist with these transactions and the existing attribute is the relevant (low index)
-                        if (controle[attrFeat[current_attributes[i].second]][supports[0].second].first <
+                        if (controle[dataReader->attrFeat[current_attributes[i].second]][supports[0].second].first <
                             current_attributes[i].second)
-                            gain.insert(std::pair<float, pair<bool, Attribute>>(
-                                    controle[attrFeat[current_attributes[i].second]][supports[0].second].second,
+                            gain.push_back(make_pair(make_pair(
+                                    controle[dataReader->attrFeat[current_attributes[i].second]][supports[0].second].second, int(gain.size())),
                                             make_pair(false, current_attributes[i].second)));
                         else {
                             //attribute of this feature exist with these transactions but this one is more relevant (low index)
-                            for (auto itr = gain.find(
-                                    controle[attrFeat[current_attributes[i].second]][supports[0].second].second);
-                                 itr != gain.end(); itr++)
-                                if (itr->second.second ==
-                                    controle[attrFeat[current_attributes[i].second]][supports[0].second].first) {
+                            for (auto itr = gain.begin(); itr != gain.end(); itr++)
+                                if (itr->first.first == controle[dataReader->attrFeat[current_attributes[i].second]][supports[0].second].second &&
+                                    itr->second.second == controle[dataReader->attrFeat[current_attributes[i].second]][supports[0].second].first) {
                                     itr->second.first = false;
-                                    gain.insert(std::pair<float, pair<bool, Attribute>>(itr->first, make_pair(true,
-                                                                                                              current_attributes[i].second)));
+                                    gain.push_back(make_pair(make_pair(itr->first.first, int(gain.size())), make_pair(true, current_attributes[i].second)));
                                     break;
                                 }
                         }
                     } else { //when there is not heuristic
 
-                        int sizeBefore = int(control[attrFeat[current_attributes[i].second]].size());
-                        control[attrFeat[current_attributes[i].second]].insert(supports[0].second);
-                        int sizeAfter = int(control[attrFeat[current_attributes[i].second]].size());
+                        int sizeBefore = int(control[dataReader->attrFeat[current_attributes[i].second]].size());
+                        control[dataReader->attrFeat[current_attributes[i].second]].insert(supports[0].second);
+                        int sizeAfter = int(control[dataReader->attrFeat[current_attributes[i].second]].size());
 
                         a_attributes2.push_back(make_pair(sizeAfter != sizeBefore, current_attributes[i].second));
                     }
                 } else {
 
                     if (infoGain)
-                        gain.insert(std::pair<float, pair<bool, Attribute>>(informationGain(supports[0], supports[1]),
+                        gain.push_back(make_pair(make_pair(informationGain(supports[0], supports[1]), int(gain.size())),
                                 make_pair(true, current_attributes[i].second)));
                     else a_attributes2.push_back(make_pair(true, current_attributes[i].second));
 
@@ -418,39 +682,22 @@ Array<pair<bool, Attribute> > LcmPruned::getSuccessors(Array<pair<bool, Attribut
             }
             /*else {
                 if (infoGain)
-                    gain.insert(std::pair<float, pair<bool, Attribute>>(NO_GAIN, make_pair(false,
+                    gain.push_back(make_pair(make_pair(NO_GAIN, int(gain.size())), make_pair(false,
                                                                                            current_attributes[i].second)));
                 else a_attributes2.push_back(make_pair(false, current_attributes[i].second));
             }*/
-
-            if (to_delete){
-                deleteSupports(supports[0].first);
-                deleteSupports(supports[1].first);
-            }
         }
         /*else {
             if (infoGain)
-                gain.insert(
-                        std::pair<float, pair<bool, Attribute>>(NO_GAIN, make_pair(false, current_attributes[i].second)));
+                gain.push_back(
+                        make_pair(make_pair(NO_GAIN, int(gain.size())), make_pair(false, current_attributes[i].second)));
             else a_attributes2.push_back(current_attributes[i]);
         }*/
     }
 
 
-    if (infoGain) {
-        if (infoAsc) { //items with low IG first
-            multimap<float, pair<bool, int>>::iterator it;
-            for (it = gain.begin(); it != gain.end(); ++it) {
-                a_attributes2.push_back(it->second);
-            }
-        } else { //items with high IG first
-            multimap<float, pair<bool, int>>::reverse_iterator it;
-            for (it = gain.rbegin(); it != gain.rend(); ++it) {
-                a_attributes2.push_back(it->second);
-            }
-        }
-
-    }
+    if (infoGain) //if infoAsc, items with low IG first. Otherwise, items with high IG first
+        buffers->sortByGain(a_attributes2, infoAsc);
     if (!allDepths)
         infoGain = false;
 
@@ -458,8 +705,9 @@ Array<pair<bool, Attribute> > LcmPruned::getSuccessors(Array<pair<bool, Attribut
 
 }
 
-void LcmPruned::printItemset(Array<Item> itemset) {
-    if (verbose) {
+template<class Query_>
+void LcmPruned<Query_>::printItemset(Array<Item> itemset) {
+    if (Logger::enable) {
         for (int i = 0; i < itemset.size; ++i) {
             cout << itemset[i] << ",";
         }
@@ -467,11 +715,18 @@ void LcmPruned::printItemset(Array<Item> itemset) {
     }
 }
 
-Array<pair<bool, Attribute> > LcmPruned::getExistingSuccessors(TrieNode* node) {
-    Array<pair<bool, Attribute>> a_attributes2(node->edges.size(), 0);
-    for(TrieEdge edge : node->edges){
-        if (edge.item % 2 == 0)
-            a_attributes2.push_back(make_pair(true, item_attribute(edge.item)));
+template<class Query_>
+Array<pair<bool, Attribute> > LcmPruned<Query_>::getExistingSuccessors(Node node) {
+    const TrieEdges& edges = trie->edges(node);
+    Array<pair<bool, Attribute>> a_attributes2(edges.size, 0);
+    for (uint32_t i = 0; i < edges.size; ++i){
+        if (edges.elts[i].item % 2 == 0)
+            a_attributes2.push_back(make_pair(true, item_attribute(edges.elts[i].item)));
     }
     return a_attributes2;
-}
\ No newline at end of file
+}
+
+template class LcmPruned<Query_TotalFreq<MisclassificationError>>;
+template class LcmPruned<Query_TotalFreq<PluginError>>;
+template class LcmPruned<Query_TotalFreq<WeightedError>>;
+template class LcmPruned<Query_TotalFreq<CallbackError>>;
@@ -0,0 +1,71 @@
+#include "numa.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__linux__)
+// cpus of a list such as 0-3,8-11
+vector<int> parseCpuList(const string& list) {
+    vector<int> cpus;
+    stringstream ranges(list);
+    string range;
+    while (getline(ranges, range, ',')) {
+        if (range.empty() || range == "\n")
+            continue;
+        size_t dash = range.find('-');
+        int first = stoi(range.substr(0, dash));
+        int last = dash == string::npos ? first : stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+#endif
+
+vector<vector<int>> readNumaNodes() {
+    vector<vector<int>> nodes;
+#if defined(__linux__)
+    // the nodes are numbered from 0, without gap on the hosts seen so far: stop at the first one missing
+    for (int node = 0;; ++node) {
+        ifstream file("/sys/devices/system/node/node" + to_string(node) + "/cpulist");
+        string list;
+        if (!file || !getline(file, list))
+            break;
+        try {
+            vector<int> cpus = parseCpuList(list);
+            if (!cpus.empty()) // nodes of memory only get no thread
+                nodes.push_back(cpus);
+        } catch (...) {
+            nodes.clear();
+            break;
+        }
+    }
+#endif
+    if (nodes.empty())
+        nodes.emplace_back();
+    return nodes;
+}
+
+const vector<vector<int>>& numaNodes() {
+    static const vector<vector<int>> nodes = readNumaNodes();
+    return nodes;
+}
+
+bool pinThread(const vector<int>& cpus) {
+#if defined(__linux__)
+    if (cpus.empty())
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
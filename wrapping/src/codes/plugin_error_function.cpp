@@ -0,0 +1,84 @@
+#include "plugin_error_function.h"
+#include <stdexcept>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+ErrorPlugin::ErrorPlugin(DL85ErrorPlugin *plugin, void *library): plugin(plugin), library(library) {
+    if (plugin->abi_version != DL85_ERROR_PLUGIN_ABI_VERSION)
+        throw runtime_error("error plugin: ABI version " + to_string(plugin->abi_version) + " is not supported (expected " + to_string(DL85_ERROR_PLUGIN_ABI_VERSION) + ")");
+    if (plugin->node_error == nullptr)
+        throw runtime_error("error plugin: node_error function is missing");
+}
+
+ErrorPlugin* ErrorPlugin::load(const string &path) {
+#if defined(_WIN32)
+    HMODULE library = LoadLibraryA(path.c_str());
+    if (library == nullptr)
+        throw runtime_error("error plugin: cannot load " + path);
+    void* symbol = (void*) GetProcAddress(library, DL85_ERROR_PLUGIN_SYMBOL);
+    if (symbol == nullptr) {
+        FreeLibrary(library);
+        throw runtime_error("error plugin: " + path + " does not export " + DL85_ERROR_PLUGIN_SYMBOL);
+    }
+#else
+    void* library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (library == nullptr)
+        throw runtime_error("error plugin: cannot load " + path + ": " + dlerror());
+    void* symbol = dlsym(library, DL85_ERROR_PLUGIN_SYMBOL);
+    if (symbol == nullptr) {
+        dlclose(library);
+        throw runtime_error("error plugin: " + path + " does not export " + DL85_ERROR_PLUGIN_SYMBOL);
+    }
+#endif
+    try {
+        return new ErrorPlugin((DL85ErrorPlugin*) symbol, (void*) library);
+    } catch (...) {
+#if defined(_WIN32)
+        FreeLibrary(library);
+#else
+        dlclose(library);
+#endif
+        throw;
+    }
+}
+
+ErrorPlugin* ErrorPlugin::fromAddress(size_t address) {
+    if (address == 0)
+        throw runtime_error("error plugin: null address");
+    return new ErrorPlugin((DL85ErrorPlugin*) address, nullptr);
+}
+
+ErrorPlugin::~ErrorPlugin() {
+    if (initialized && plugin->destroy != nullptr)
+        plugin->destroy(state);
+    if (library != nullptr) {
+#if defined(_WIN32)
+        FreeLibrary((HMODULE) library);
+#else
+        dlclose(library);
+#endif
+    }
+}
+
+void ErrorPlugin::init(DataManager *dm) {
+    nclasses = dm->getNClasses();
+    if (plugin->init != nullptr)
+        state = plugin->init(plugin->user_data, dm->getNTransactions(), nclasses, dm->getSupports());
+    initialized = true;
+}
+
+Error ErrorPlugin::nodeError(RCover *cover, Supports supports, Class *prediction, Error *lowerBound) {
+    const uint64_t* words = nullptr;
+    if (plugin->needs_cover) {
+        cover->getCoverWords();
+        words = (const uint64_t*) cover->words;
+    }
+    int predicted = 0;
+    Error error = plugin->node_error(state, words, cover->nWords, supports, nclasses, &predicted);
+    *prediction = predicted;
+    *lowerBound = (plugin->lower_bound == nullptr) ? 0 : plugin->lower_bound(state, words, cover->nWords, supports, nclasses);
+    return error;
+}
@@ -5,94 +5,117 @@
 
 using namespace std;
 
-Query_Best::Query_Best(Trie *Trie, DataManager *data, ExpError *experror, int timeLimit, bool continuous, function<vector<float>(RCover*)>* error_callback, function<vector<float>(RCover*)>* fast_error_callback, function<float(RCover*)>*  predictor_error_callback, float maxError, bool stopAfterError )
-  : Query(trie,data,timeLimit,continuous, error_callback, fast_error_callback, predictor_error_callback, maxError, stopAfterError),experror ( experror )
+template<class E>
+Query_Best<E>::Query_Best(Trie<E> *trie, DataManager *data, ExpError *experror, int timeLimit, bool continuous, function<vector<float>(RCover*)>* error_callback, function<vector<float>(RCover*)>* fast_error_callback, function<float(RCover*)>*  predictor_error_callback, float maxError, bool stopAfterError )
+  : Query(data,timeLimit,continuous, error_callback, fast_error_callback, predictor_error_callback, maxError, stopAfterError),trie ( trie ),experror ( experror )
 {
 }
 
 
-Query_Best::~Query_Best()
+template<class E>
+Query_Best<E>::~Query_Best()
 {
 }
 
 
-string Query_Best::printResult ( DataManager *data2 ) {
-    return printResult ( data2, (QueryData_Best*) realroot->data );
+template<class E>
+string Query_Best<E>::printResult ( DataManager *data2 ) {
+    return printResult ( data2, realroot );
 }
 
-string Query_Best::printResult ( DataManager *data2, QueryData_Best *data ) {
+template<class E>
+string Query_Best<E>::printResult ( DataManager *data2, Node node ) {
     int depth;
     string out = "";
     out += "(nItems, nTransactions) : ( " + std::to_string(data2->getNAttributes()*2) + ", " + std::to_string(data2->getNTransactions()) + " )\n";
     out += "Tree: ";
-    if ( data->size == 0 || (data->size == 1 && data->error == FLT_MAX) ){
+    if ( trie->size(node) == 0 || (trie->size(node) == 1 && trie->error(node) == noError<E>()) ){
         out += "(No such tree)\n";
         printTimeOut(&out);
         return out;
     }
     else {
-        depth = printResult ( data, 1, &out );
+        depth = printResult ( node, 1, &out );
         out += "}\n";
-        out += "Size: " + std::to_string(data->size) + "\n";
+        out += "Size: " + std::to_string(trie->size(node)) + "\n";
         out += "Depth: " + std::to_string(depth - 1) + "\n";
-        out += "Error: " + std::to_string(data->error) + "\n";
-        printAccuracy(data2, data, &out);
+        out += "Error: " + std::to_string((double) trie->error(node)) + "\n";
+        printAccuracy(data2, node, &out);
         printTimeOut(&out);
         return out;
     }
 }
 
-int Query_Best::printResult ( QueryData_Best *data, int depth, string* out ) {
-    if ( data->left == NULL ) { // leaf
+template<class E>
+int Query_Best<E>::printResult ( Node node, int depth, string* out ) {
+    if ( trie->left(node) == NO_NODE ) { // leaf
         if (predictor_error_callback != nullptr)
-            *out += "{\"value\": \"undefined\", \"error\": " + std::to_string(data->error);
+            *out += "{\"value\": \"undefined\", \"error\": " + std::to_string((double) trie->error(node));
         else
-            *out += "{\"value\": " + std::to_string(data->test) + ", \"error\": " + std::to_string(data->error);
+            *out += "{\"value\": " + std::to_string(trie->test(node)) + ", \"error\": " + std::to_string((double) trie->error(node));
         return depth;
     }
     else {
         if (continuous)
-            *out += "{\"feat\": " + ((DataContinuous*) this->data)->names[data->test] + ", \"left\": ";
+            *out += "{\"feat\": " + ((DataContinuous*) this->data)->names[trie->test(node)] + ", \"left\": ";
         else
-            *out += "{\"feat\": " + std::to_string(data->test) + ", \"left\": ";
-        int d1 = printResult ( data->right, depth + 1, out );
+            *out += "{\"feat\": " + std::to_string(trie->test(node)) + ", \"left\": ";
+        int d1 = printResult ( trie->right(node), depth + 1, out );
         // perhaps strange, but we have stored the positive outcome in right, generally, people think otherwise... :-)
         *out += "}, \"right\": ";
-        int d2 = printResult ( data->left, depth + 1, out );
+        int d2 = printResult ( trie->left(node), depth + 1, out );
         *out += "}";
         return max ( d1, d2 );
     }
 }
 
-void Query_Best::printTimeOut(string* out){
-    if (timeLimitReached)
-        *out += "Timeout\n";// << endl;
+template<class E>
+string Query_Best<E>::printTree ( Node node ) {
+    string tree = "";
+    printResult ( node, 1, &tree );
+    return tree + "}";
 }
 
-bool Query_Best::canimprove ( QueryData *left, Error ub ) {
-    return ((QueryData_Best*) left )->error < ub ;
+template<class E>
+bool Query_Best<E>::publishSolution ( Node node, E lowerBound ) {
+    if ( solution_callback == nullptr )
+        return false;
+    string tree = printTree ( node );
+    float error = (float) trie->error(node), bound = (float) lowerBound;
+    float gap = ( error > 0 ) ? ( error - bound ) / error : 0;
+    if ( (*solution_callback) ( tree, error, bound, gap ) ) {
+        timeLimitReached = true; // the solution is returned as the one of a search stopped by the time limit
+        return true;
+    }
+    return false;
 }
 
-bool Query_Best::canSkip( QueryData *actualBest ){
-    Logger::showMessageAndReturn("checking canSkip");
-    // std::cout << "checking canSkip" << std::endl;
-    return ((QueryData_Best*) actualBest )->error <= ((QueryData_Best*) actualBest )->lowerBound;
+template<class E>
+void Query_Best<E>::printTimeOut(string* out){
+    if (timeLimitReached)
+        *out += "Timeout\n";// << endl;
 }
 
-void Query_Best::printAccuracy ( DataManager *data2, QueryData_Best *data, string* out ) {
+template<class E>
+void Query_Best<E>::printAccuracy ( DataManager * /*data2*/, Node /*node*/, string* out ) {
     *out += "Accuracy: 0\n";// << endl;
 }
 
-/*Class Query_Best::runResult ( DataManager *data, Transaction transaction ) {
-  return runResult ( (QueryData_Best*) realroot->data, data, transaction );  
+/*template<class E>
+Class Query_Best<E>::runResult ( DataManager *data, Transaction transaction ) {
+  return runResult ( realroot, data, transaction );
 }
 
-Class Query_Best::runResult ( QueryData_Best *data2, DataManager *data, Transaction transaction ) {
-  if ( data2->left == NULL )  // leaf
-    return data2->test;
+template<class E>
+Class Query_Best<E>::runResult ( Node node, DataManager *data, Transaction transaction ) {
+  if ( trie->left(node) == NO_NODE )  // leaf
+    return trie->test(node);
   else
-    if ( data->isIn ( transaction, data2->test ) )
-      return runResult ( data2->right, data, transaction );
+    if ( data->isIn ( transaction, trie->test(node) ) )
+      return runResult ( trie->right(node), data, transaction );
     else
-      return runResult ( data2->left, data, transaction );
+      return runResult ( trie->left(node), data, transaction );
 }*/
+
+template class Query_Best<Error>;
+template class Query_Best<CountError>;
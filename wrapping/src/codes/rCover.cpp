@@ -4,13 +4,21 @@
 
 #include "rCover.h"
 #include <cmath>
+#include <algorithm>
 
-RCover::RCover(DataManager *dmm):dm(dmm) {
+#define INITIAL_DEPTHS 16
+
+RCover::RCover(DataManager *dmm, const bitset<M>* mask):dm(dmm) {
     nWords = (int)ceil((float)dm->getNTransactions()/M);
-    coverWords = new stack<bitset<M>>[nWords];
+    stride = (nWords + 7) / 8 * 8;
+    capacity = INITIAL_DEPTHS;
+    coverBlock = new BitsetBlock((size_t) capacity * stride * sizeof(bitset<M>));
+    coverWords = (bitset<M>*) coverBlock->data();
     validWords = new int[nWords];
+    tids = new Transaction[dm->getNTransactions()];
+    words = new unsigned long long[nWords];
+    int nValid = 0, nEmpty = 0; // the empty words of the mask are put after the valid ones
     for (int i = 0; i < nWords; ++i) {
-        stack<bitset<M>> rword;
         bitset<M> word;
         word.set();
         if(i == 0 && dm->getNTransactions()%M != 0){
@@ -18,24 +26,32 @@ RCover::RCover(DataManager *dmm):dm(dmm) {
                 word.set(j, false);
             }
         }
-        rword.push(word);
-        coverWords[i] = rword;
-        validWords[i] = i;
+        if (mask != nullptr)
+            word &= mask[i];
+        coverWords[i] = word;
+        if (word.none())
+            validWords[nWords - ++nEmpty] = i;
+        else
+            validWords[nValid++] = i;
     }
-    limit.push(nWords);
+    limit.push(nValid);
 }
 
 void RCover::intersect(Attribute attribute, bool positive) {
-    //cout << "intersect" << endl;
+    if (depth + 1 == capacity)
+        grow();
     int climit = limit.top();
-    //cout << "limit = " << climit << endl;
+    const bitset<M>* column = dm->getAttributeCover(attribute);
+    const bitset<M>* current = coverWords + (size_t) depth * stride;
+    bitset<M>* next = coverWords + (size_t) (depth + 1) * stride;
     for (int i = 0; i < climit; ++i) {
+        int word = validWords[i];
         if (positive)
-            coverWords[validWords[i]].push(coverWords[validWords[i]].top() & dm->getAttributeCover(attribute)[validWords[i]]);
+            next[word] = current[word] & column[word];
         else
-            coverWords[validWords[i]].push(coverWords[validWords[i]].top() & ~(dm->getAttributeCover(attribute)[validWords[i]]) );
+            next[word] = current[word] & ~column[word];
 
-        if (coverWords[validWords[i]].top().none()){
+        if (next[word].none()){
             int tmp = validWords[climit-1];
             validWords[climit-1] = validWords[i];
             validWords[i] = tmp;
@@ -43,27 +59,36 @@ void RCover::intersect(Attribute attribute, bool positive) {
             --i;
         }
     }
+    ++depth;
     limit.push(climit);
-    //cout << "done" << endl;
+}
+
+void RCover::grow() {
+    BitsetBlock* block = new BitsetBlock((size_t) 2 * capacity * stride * sizeof(bitset<M>));
+    copy_n(coverWords, (size_t) capacity * stride, (bitset<M>*) block->data());
+    delete coverBlock;
+    coverBlock = block;
+    coverWords = (bitset<M>*) block->data();
+    capacity *= 2;
 }
 
 int RCover::getSupport() {
     int sum = 0;
     for (int i = 0; i < limit.top(); ++i) {
-        sum += coverWords[validWords[i]].top().count();
+        sum += top(validWords[i]).count();
     }
     return sum;
 }
 
-pair<Supports, Support> RCover::getSupportPerClass(){
+pair<Supports, Support> RCover::getSupportPerClass(Supports supports){
     pair<Supports, Support> itemsetSupport;
-    itemsetSupport.first = newSupports();
-    zeroSupports(itemsetSupport.first);
-    for (int j = 0; j < nclasses; ++j) {
+    itemsetSupport.first = supports;
+    itemsetSupport.second = 0;
+    for (int j = 0; j < dm->getNClasses(); ++j) {
         bitset<M> * classCover = dm->getClassCover(j);
         int sum = 0;
         for (int i = 0; i < limit.top(); ++i) {
-            sum += (coverWords[validWords[i]].top() & classCover[validWords[i]]).count();
+            sum += (top(validWords[i]) & classCover[validWords[i]]).count();
         }
         itemsetSupport.first[j] = sum;
         itemsetSupport.second += sum;
@@ -71,6 +96,25 @@ pair<Supports, Support> RCover::getSupportPerClass(){
     return itemsetSupport;
 }
 
+float RCover::getWeightedSupportPerClass(const float* weights, float* supports){
+    float total = 0;
+    for (int j = 0; j < dm->getNClasses(); ++j) {
+        bitset<M> * classCover = dm->getClassCover(j);
+        float sum = 0;
+        for (int i = 0; i < limit.top(); ++i) {
+            const float* wordWeights = weights + (nWords - (validWords[i]+1)) * M;
+            unsigned long long word = (top(validWords[i]) & classCover[validWords[i]]).to_ullong();
+            while (word) {
+                sum += wordWeights[lowestSetBit(word)];
+                word &= word - 1; // clear the lowest set bit
+            }
+        }
+        supports[j] = sum;
+        total += sum;
+    }
+    return total;
+}
+
 Support RCover::getSupportForWarm(){
     Support support = 0;
     bitset<M> * warmCover = dm->getWarmCover();
@@ -78,7 +122,7 @@ Support RCover::getSupportForWarm(){
         return -1;
     }
     for (int i = 0; i < limit.top(); ++i) {
-        support += (coverWords[validWords[i]].top() & warmCover[validWords[i]]).count();
+        support += (top(validWords[i]) & warmCover[validWords[i]]).count();
     }
     return support;
 }
@@ -96,34 +140,51 @@ int* RCover::getClassSupport(){
     return classSupport;
 }
 
-/*vector<int> RCover::getTransactionsID() {
-    vector<int> tid;
+int RCover::getTransactionsID() {
+    int ntids = 0;
+    for (int i = 0; i < limit.top(); ++i) {
+        int indexForTransactions = nWords - (validWords[i]+1);
+        unsigned long long word = top(validWords[i]).to_ullong();
+        while (word) {
+            tids[ntids++] = indexForTransactions * M + lowestSetBit(word);
+            word &= word - 1; // clear the lowest set bit
+        }
+    }
+    return ntids;
+}
+
+int RCover::getClassTransactionsID(Class clas) {
+    bitset<M> * classCover = dm->getClassCover(clas);
+    int ntids = 0;
     for (int i = 0; i < limit.top(); ++i) {
         int indexForTransactions = nWords - (validWords[i]+1);
-        bitset<M> word = coverWords[validWords[i]].top();
-        int pos = getFirstSetBitPos(word.to_ulong());
-        int transInd = pos - 1;
-        while (pos >= 0){
-            tid.push_back(indexForTransactions * M + transInd );
-            word = (word >> pos);
-            pos = getFirstSetBitPos(word.to_ulong());
-            transInd += pos;
+        unsigned long long word = (top(validWords[i]) & classCover[validWords[i]]).to_ullong();
+        while (word) {
+            tids[ntids++] = indexForTransactions * M + lowestSetBit(word);
+            word &= word - 1; // clear the lowest set bit
         }
     }
-    return tid;
-}*/
+    return ntids;
+}
+
+int RCover::getCoverWords() {
+    for (int i = 0; i < nWords; ++i)
+        words[i] = 0;
+    for (int i = 0; i < limit.top(); ++i)
+        words[nWords - (validWords[i]+1)] = top(validWords[i]).to_ullong();
+    return nWords;
+}
 
 void RCover::backtrack() {
+    // the words of the previous depth are still there
     limit.pop();
-    int climit = limit.top();
-    for (int i = 0; i < climit; ++i) {
-        coverWords[validWords[i]].pop();
-    }
+    --depth;
 }
 
 void RCover::print() {
     for (int i = 0; i < nWords; ++i) {
-        cout << coverWords[i].top() << " ";
+        bool valid = find(validWords, validWords + limit.top(), i) != validWords + limit.top();
+        cout << (valid ? top(i) : bitset<M>()) << " ";
     }
     cout << endl;
-}
\ No newline at end of file
+}
@@ -0,0 +1,52 @@
+#include "successor_cache.h"
+
+SuccessorCache::SuccessorCache(size_t capacity): capacity(capacity) {
+}
+
+static int capacityBits(uint32_t size) {
+    int bits = 0;
+    while ((1u << bits) < size)
+        ++bits;
+    return bits;
+}
+
+bool SuccessorCache::find(Node node, Array<pair<bool, Attribute>> &successors) const {
+    if (node >= lists.size() || lists[node] == nullptr)
+        return false;
+    const uint32_t *list = lists[node];
+    successors.resize(0);
+    for (uint32_t i = 1; i <= list[0]; ++i)
+        successors.push_back(make_pair((bool) (list[i] & 1), (Attribute) (list[i] >> 1)));
+    return true;
+}
+
+void SuccessorCache::store(Node node, Array<pair<bool, Attribute>> successors) {
+    if (node < lists.size() && lists[node] != nullptr)
+        return;
+    int bits = capacityBits((uint32_t) successors.size + 1);
+    uint32_t *list;
+    if (!freeLists[bits].empty()) {
+        list = freeLists[bits].back();
+        freeLists[bits].pop_back();
+    }
+    else {
+        size_t size = sizeof(uint32_t) << bits;
+        if (used + size > capacity) // full: the successors of the node will be computed again
+            return;
+        list = (uint32_t*) arena.allocate(size, alignof(uint32_t));
+        used += size;
+    }
+    list[0] = (uint32_t) successors.size;
+    forEach (i, successors)
+        list[i + 1] = ((uint32_t) successors[i].second << 1) | (uint32_t) successors[i].first;
+    if (node >= lists.size())
+        lists.resize(node + 1, nullptr);
+    lists[node] = list;
+}
+
+void SuccessorCache::release(Node node) {
+    if (node >= lists.size() || lists[node] == nullptr)
+        return;
+    freeLists[capacityBits(lists[node][0] + 1)].push_back(lists[node]);
+    lists[node] = nullptr;
+}
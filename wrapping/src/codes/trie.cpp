@@ -4,23 +4,21 @@
 using namespace std;
 
 
-Trie::Trie() {
-  root = new TrieNode;
-  root->data = NULL;
+template<class E>
+Trie<E>::Trie() {
+  root = newNode ();
 }
 
 
-TrieNode::~TrieNode () {
-  if ( data ){
-    //free ( data ); // assumed allocated with malloc
-    delete(data);
-  }
-  for ( vector<TrieEdge>::iterator i = edges.begin (); i != edges.end (); ++i )
-    delete i->subtrie;
+template<class E>
+Trie<E>::~Trie() {
 }
 
-Trie::~Trie() {
-  delete root;
+template<class E>
+size_t Trie<E>::memory () const {
+  return edgeMemory + nodeEdges.memory () + hasDatas.memory () + tests.memory () + lefts.memory () + rights.memory ()
+         + leafErrors.memory () + errors.memory () + initUbs.memory () + lowerBounds.memory () + sizes.memory ()
+         + solutionDepths.memory ();
 }
 
 bool lessTrieEdge (const TrieEdge edge, const Item item )
@@ -28,32 +26,75 @@ bool lessTrieEdge (const TrieEdge edge, const Item item )
   return edge.item < item;
 }
 
-TrieNode *Trie::createTree ( Array<Item> itemset, int pos, TrieNode *&last ) {
-  TrieNode *r2;
-  last = r2 = new TrieNode;
-  r2->data = NULL;
+template<class E>
+Node Trie<E>::newNode () {
+  TrieEdges empty = { nullptr, 0, 0 };
+  nodeEdges.push_back ( empty );
+  hasDatas.push_back ( false );
+  tests.push_back ( -1 );
+  lefts.push_back ( NO_NODE );
+  rights.push_back ( NO_NODE );
+  leafErrors.push_back ( noError<E> () );
+  errors.push_back ( noError<E> () );
+  initUbs.push_back ( noError<E> () );
+  lowerBounds.push_back ( 0 );
+  sizes.push_back ( 0 );
+  solutionDepths.push_back ( -1 );
+  return (Node) ( nodeEdges.size () - 1 );
+}
+
+template<class E>
+void Trie<E>::insertEdge ( Node node, uint32_t pos, TrieEdge edge ) {
+  TrieEdges &e = nodeEdges[node];
+  if ( e.size == e.capacity ) { // move the edges to an array twice as large and keep the old one for another node
+    int bits = 0;
+    while ( ( 1u << bits ) < e.capacity * 2 )
+      ++bits;
+    TrieEdge *elts;
+    if ( freeEdges[bits].empty () ) {
+      elts = (TrieEdge*) arena.allocate ( sizeof ( TrieEdge ) << bits, alignof ( TrieEdge ) );
+      edgeMemory += sizeof ( TrieEdge ) << bits;
+    }
+    else {
+      elts = freeEdges[bits].back ();
+      freeEdges[bits].pop_back ();
+    }
+    copy ( e.elts, e.elts + e.size, elts );
+    if ( e.capacity > 0 )
+      freeEdges[bits - 1].push_back ( e.elts );
+    e.elts = elts;
+    e.capacity = 1u << bits;
+  }
+  copy_backward ( e.elts + pos, e.elts + e.size, e.elts + e.size + 1 );
+  e.elts[pos] = edge;
+  ++e.size;
+}
+
+template<class E>
+Node Trie<E>::createTree ( Array<Item> itemset, int pos, Node &last ) {
+  Node r2;
+  last = r2 = newNode ();
   for ( int i = itemset.size - 2; i >= pos; --i ) { /// from
     TrieEdge newedge;
     newedge.item = itemset[i + 1];
     newedge.subtrie = r2;
-    r2 = new TrieNode;
-    r2->edges.reserve ( 1 ); // assume that this is common
-    r2->edges.push_back ( newedge );
-    r2->data = NULL;
+    r2 = newNode ();
+    insertEdge ( r2, 0, newedge );
   }
   return r2;
 }
 
-TrieNode *Trie::find ( Array<Item> itemset ) { ///seek itemset in the trie from root. Return null if not exist and the node of the last item if it exists
-  TrieNode *p = root, *p2;
-  vector<TrieEdge>::iterator t, e;
-  
+template<class E>
+Node Trie<E>::find ( Array<Item> itemset ) { ///seek itemset in the trie from root. Return NO_NODE if not exist and the node of the last item if it exists
+  Node p = root;
+  TrieEdge *t, *e;
+
   forEach ( i, itemset ) {
-    e = p->edges.end ();
-    t = lower_bound(p->edges.begin(), e, itemset[i], lessTrieEdge);
+    e = nodeEdges[p].elts + nodeEdges[p].size;
+    t = lower_bound(nodeEdges[p].elts, e, itemset[i], lessTrieEdge);
     if ( t == e || t->item != itemset[i] ) {
       // not found
-      return NULL;
+      return NO_NODE;
     }
     else
       p = t->subtrie;
@@ -61,20 +102,21 @@ TrieNode *Trie::find ( Array<Item> itemset ) { ///seek itemset in the trie from
   return p;
 }
 
-TrieNode *Trie::insert ( Array<Item> itemset ) { /// insert itemset. Check from root and insert items only they do not exist using createTree
-  TrieNode *p = root, *p2;
-  vector<TrieEdge>::iterator t, e;
-  
+template<class E>
+Node Trie<E>::insert ( Array<Item> itemset ) { /// insert itemset. Check from root and insert items only they do not exist using createTree
+  Node p = root, p2;
+  TrieEdge *t, *e;
+
   forEach ( i, itemset ) {
-    e = p->edges.end ();
-    t = lower_bound(p->edges.begin(), e, itemset[i], lessTrieEdge);
+    e = nodeEdges[p].elts + nodeEdges[p].size;
+    t = lower_bound(nodeEdges[p].elts, e, itemset[i], lessTrieEdge);
     if ( t == e || t->item != itemset[i] ) { /// if item does not exist
-      // not found, insert 
+      // not found, insert
       TrieEdge newedge;
       newedge.item = itemset[i];
-      p2 = p;
+      uint32_t pos = (uint32_t) ( t - nodeEdges[p].elts );
       newedge.subtrie = createTree ( itemset, i, p2 );/// create path representing the part of the itemset not yet present in the trie. So you have to provide the position at which the part not present starts and the last node at which we must complete the tree
-      p->edges.insert ( t, newedge );
+      insertEdge ( p, pos, newedge );
 
       return p2;
     }
@@ -84,3 +126,6 @@ TrieNode *Trie::insert ( Array<Item> itemset ) { /// insert itemset. Check from
   }
   return p;
 }
+
+template class Trie<Error>;
+template class Trie<CountError>;
@@ -0,0 +1,160 @@
+#ifndef DL85_ARENA_H
+#define DL85_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include "globals.h"
+
+using namespace std;
+
+/// bump allocator of a search: memory is handed out from large blocks and only released all at once when the
+/// arena is destroyed. Objects created in an arena never have their destructor called
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 1 << 20);
+
+    ~Arena();
+
+    void* allocate(size_t size, size_t alignment);
+
+    template<class T, class... Args>
+    T* create(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /// number of blocks requested to the system
+    size_t getNBlocks() const { return blocks.size(); }
+
+private:
+    vector<char*> blocks;
+    char* current = nullptr;
+    size_t remaining = 0;
+    size_t blockSize;
+};
+
+/// STL allocator drawing from an arena. deallocate is a no-op: the memory is reclaimed with the arena
+template<class T>
+struct ArenaAllocator {
+    typedef T value_type;
+
+    Arena* arena;
+
+    explicit ArenaAllocator(Arena* arena) : arena(arena) {}
+
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return (T*) arena->allocate(n * sizeof(T), alignof(T)); }
+
+    void deallocate(T*, size_t) {}
+
+    template<class U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+    template<class U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+/// array growing by fixed-size chunks: elements never move, so references to them stay valid while it grows, and
+/// growing does not copy the elements already stored
+template<class T, int chunkBits = 16>
+class ChunkedArray {
+public:
+    ChunkedArray() {}
+
+    ChunkedArray(const ChunkedArray&) = delete;
+
+    ChunkedArray& operator=(const ChunkedArray&) = delete;
+
+    ~ChunkedArray() {
+        for (T* chunk : chunks)
+            delete[] chunk;
+    }
+
+    T& operator[](size_t i) { return chunks[i >> chunkBits][i & (chunkSize - 1)]; }
+
+    const T& operator[](size_t i) const { return chunks[i >> chunkBits][i & (chunkSize - 1)]; }
+
+    void push_back(const T& value) {
+        if ((count & (chunkSize - 1)) == 0)
+            chunks.push_back(new T[chunkSize]);
+        (*this)[count++] = value;
+    }
+
+    size_t size() const { return count; }
+
+    /// bytes reserved for the elements
+    size_t memory() const { return chunks.size() * chunkSize * sizeof(T); }
+
+private:
+    static const size_t chunkSize = (size_t) 1 << chunkBits;
+    vector<T*> chunks;
+    size_t count = 0;
+};
+
+/// zeroed memory of the bitsets of the data and of the covers, aligned on 64 bytes, the size of a cache line and of the
+/// widest vector registers. The blocks of a huge page or more are backed by huge pages where the system gives them:
+/// reserved ones first, then transparent ones, and ordinary pages otherwise, so that the scans of the columns miss the
+/// TLB less often
+class BitsetBlock {
+public:
+    enum Pages { ORDINARY_PAGES, TRANSPARENT_HUGE_PAGES, RESERVED_HUGE_PAGES };
+
+    explicit BitsetBlock(size_t size);
+
+    BitsetBlock(const BitsetBlock&) = delete;
+
+    BitsetBlock& operator=(const BitsetBlock&) = delete;
+
+    ~BitsetBlock();
+
+    void* data() const { return memory; }
+
+    Pages getPages() const { return pages; }
+
+    /// whether the large blocks ask for huge pages. Only the blocks allocated afterwards are affected. Atomic, as it is
+    /// set while the searches of other threads allocate their blocks
+    static atomic<bool> hugePages;
+
+private:
+    char* memory; /// aligned start of the block
+    char* base; /// start of the allocation
+    size_t mapped = 0; /// size of the mapping of base, 0 when base comes from new
+    Pages pages = ORDINARY_PAGES;
+};
+
+/// scratch buffers of the search engines, allocated once before the search. The itemset and the successors of the
+/// node being explored at depth d are stored in the buffers of depth d, which are not touched by deeper calls
+class SearchBuffers {
+public:
+    SearchBuffers(Depth maxDepth, Attribute nattributes, Class nclasses);
+
+    ~SearchBuffers();
+
+    /// empty itemset with room for the items of a node at the given depth
+    Array<Item> itemset(Depth depth) { return Array<Item>(itemsets + depth * maxDepth, 0); }
+
+    /// empty list of successors with room for all the attributes
+    Array<pair<bool, Attribute>> successors(Depth depth) { return Array<pair<bool, Attribute>>(succs + depth * nattributes, 0); }
+
+    /// class supports of the two branches of a candidate attribute
+    Supports supports[2];
+
+    /// candidate attributes with their information gain, in order of evaluation
+    vector<pair<pair<float, int>, pair<bool, Attribute>>> gains;
+
+    /// sort the candidates by gain, ties keeping their order of evaluation, and append them to successors
+    void sortByGain(Array<pair<bool, Attribute>>& successors, bool ascending);
+
+private:
+    Depth maxDepth;
+    Attribute nattributes;
+    Item* itemsets;
+    pair<bool, Attribute>* succs;
+};
+
+#endif //DL85_ARENA_H
@@ -31,6 +31,7 @@ public:
     void write_binary(std::string filename);
     void write_binary_dl8(std::string filename);
     std::vector<std::string> names;
+    std::map<int, int> attrFeat; /// feature of each binarized attribute
 
 private:
     std::vector<std::vector<int>> b; /// matrix of data
@@ -7,6 +7,7 @@
 
 #include <bitset>
 #include "globals.h"
+#include "arena.h"
 
 using namespace std;
 
@@ -20,15 +21,15 @@ public:
 
     DataManager(int* supports, int ntransactions, int nattributes, int nclasses, int *b, int *c, int *warm);
 
-    ~DataManager(){
-        for (int i = 0; i < nattributes; ++i) {
-            delete[] b[i];
-        }
+    /// replica of the bitsets of other, allocated by the calling thread so that they lie on its NUMA node. The
+    /// supports are shared
+    DataManager(const DataManager &other);
+
+    virtual ~DataManager(){
         delete[]b;
-        for (int j = 0; j < nclasses; ++j) {
-            delete[] c[j];
-        }
         delete[]c;
+        delete[]w;
+        delete block;
     }
 
     bitset<M> * getAttributeCover(int attr);
@@ -49,7 +50,16 @@ public:
     /// get array of support of each class
     Supports getSupports () const { return supports; }
 
+    /// feature of each attribute when the attributes are the binarization of continuous features
+    map<int, int> attrFeat;
+
 private:
+    /// allocate the columns of the attributes, of the classes when target and of the predictions when warm, one after
+    /// the other in the block
+    void allocateColumns(bool target, bool warm);
+
+    BitsetBlock *block; /// memory of the columns
+    int stride; /// words from a column to the next one
     bitset<M> **b; /// matrix of data
     bitset<M> **c; /// vector of target
     bitset<M> **w; /// vector of predictions with warm start
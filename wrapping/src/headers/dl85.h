@@ -10,11 +10,206 @@
 #include <vector>
 #include <utility>
 #include <functional>
+#include <mutex>
 #include "globals.h"
 #include "rCover.h"
+#include "trie.h"
 
 using namespace std;
 
+class ExpError;
+
+// tree learnt on a part of the transactions, for a fold of a cross-validation or a member of an ensemble, with its
+// errors
+struct TreeResult {
+    string tree; // empty when there is no tree
+    float error; // on the training transactions
+    int validationError; // number of the other transactions misclassified by the tree, -1 when there is no tree
+    int latticeSize;
+    bool timeout;
+};
+
+// tree among the best ones of a search enumerating several trees
+struct RankedTree {
+    string tree;
+    float error;
+    int size;
+    int depth;
+};
+
+// trees voting for the class of the transactions, learnt by Solver::trainEnsemble or Solver::boost
+class Ensemble {
+public:
+    // write the class of each transaction of data, given by rows of nattributes values, voted by the trees with their
+    // weights. The ties go to the first class
+    void predict(const int *data, int ntransactions, int nattributes, int *predictions) const;
+
+    // in preorder: the attribute of each test followed by its positive then its negative subtree, -1 - class for a
+    // leaf. Empty for the trees not found
+    vector<vector<int>> trees;
+    vector<float> weights; // weight of the vote of each tree, 1 for all of them when empty
+    int nclasses = 0;
+};
+
+// state kept between the searches on the same data: the bitsets of the data and, for the misclassification error,
+// the cache of the last search and its best tree. The cache is reused as long as the parameters leave its solutions
+// optimal, i.e. for the same depth and the same or a larger minimum support whose constraint the best tree still
+// satisfies. Otherwise, the search restarts from an empty cache, warm started with the last best tree, whose errors
+// bound the nodes of its paths whatever the new depth and minimum support. The calls to solve and loadCheckpoint, which
+// share the cache, run one at a time: a call from another thread waits for the running one to end
+class Solver {
+public:
+    Solver(int* supports, int ntransactions, int nattributes, int nclasses, int *data, int *target, int *warm);
+
+    ~Solver();
+
+    // parameters as in search. The last best tree is the prior tree when warm_tree is empty. When depthResults is
+    // given, the search is iterative and the results of the depths it completes are appended to it, the depths being
+    // searched from 1. When maxLeaves is positive, the tree has at most maxLeaves leaves: the search keeps for each
+    // node its best subtree of each number of leaves, as enumerateTrees with pareto, for the misclassification error
+    // only. The prior tree is then not used. When checkpointPath is given, the cache of the misclassification error with
+    // the default search is written there every checkpointInterval seconds, if positive, and when the search stops, the
+    // time limit included. The nodes being searched are left out, so that the solutions of the checkpoint are optimal
+    string solve(float maxError,
+                 bool stopAfterError,
+                 bool iterative,
+                 function<vector<float>(RCover*)> error_callback,
+                 function<vector<float>(RCover*)> fast_error_callback,
+                 function<float(RCover*)> predictor_error_callback,
+                 bool error_is_null = true,
+                 bool fast_error_is_null = true,
+                 int maxdepth = 1,
+                 int minsup = 1,
+                 bool infoGain = false,
+                 bool infoAsc = true,
+                 bool repeatSort = false,
+                 int timeLimit = 0,
+                 map<int, pair<int, int>>* continuousMap = NULL,
+                 bool nps_param = false,
+                 bool verbose_param = false,
+                 bool predict = false,
+                 string error_plugin_path = "",
+                 size_t error_plugin_address = 0,
+                 bool anytime = false,
+                 function<bool(string, float, float, float)> solution_callback = nullptr,
+                 bool solution_is_null = true,
+                 int *warm_tree = nullptr,
+                 int warm_tree_size = 0,
+                 vector<string> *depthResults = nullptr,
+                 int maxLeaves = 0,
+                 string checkpointPath = "",
+                 float checkpointInterval = 0);
+
+    // load the cache written by a search with a checkpoint, and its best tree. The next search with the same depth and
+    // minimum support continues from it. Throw a runtime_error when the checkpoint is unreadable or written for other
+    // data
+    void loadCheckpoint(const string &path);
+
+    // search a tree with the misclassification error on the transactions out of each fold, the folds being numbered
+    // from 0 in folds, one per transaction. The folds are searched in parallel by nThreads threads, or one per core
+    // when nThreads is not positive. The time limit applies to each fold
+    vector<TreeResult> crossValidate(const int *folds,
+                                     int nfolds,
+                                     int maxdepth = 1,
+                                     int minsup = 1,
+                                     bool infoGain = false,
+                                     bool infoAsc = true,
+                                     bool repeatSort = false,
+                                     int timeLimit = 0,
+                                     int nThreads = 0);
+
+    // learn the trees of an ensemble in parallel as crossValidate, each with the misclassification error on a sample
+    // of the transactions and a subset of the attributes. The sample of tree i is given by the nonzero values of the
+    // row i of samples, ntrees rows of one value per transaction. Its attributes are given likewise by features, all
+    // of them when features is null. Each tree is validated on the transactions out of its sample. The ensemble
+    // receives the trees
+    vector<TreeResult> trainEnsemble(const int *samples,
+                                     const int *features,
+                                     int ntrees,
+                                     int maxdepth,
+                                     int minsup,
+                                     bool infoGain,
+                                     bool infoAsc,
+                                     bool repeatSort,
+                                     int timeLimit,
+                                     int nThreads,
+                                     Ensemble *ensemble);
+
+    // learn at most ntrees trees by boosting (SAMME): each tree minimizes the misclassification error of the
+    // transactions weighted by the previous rounds, where the transactions misclassified weigh more. The boosting
+    // stops at a tree without error or no better than chance. The ensemble receives the trees and their weights
+    vector<TreeResult> boost(int ntrees,
+                             int maxdepth,
+                             int minsup,
+                             bool infoGain,
+                             bool infoAsc,
+                             bool repeatSort,
+                             int timeLimit,
+                             Ensemble *ensemble);
+
+    // search the maxTrees best trees with the misclassification error whose error is within epsilon of the best one,
+    // the best first. The list of each node of the search keeps as many subtrees, which bounds its memory. With
+    // pareto, search instead the Pareto front of the error and the size, the best error first, of the trees of at most
+    // maxLeaves leaves when it is positive. The number of nodes
+    // explored is written in latticeSize and whether the time limit was reached in timeout
+    vector<RankedTree> enumerateTrees(int maxTrees,
+                                      float epsilon,
+                                      bool pareto,
+                                      int maxLeaves,
+                                      int maxdepth,
+                                      int minsup,
+                                      int timeLimit,
+                                      int *latticeSize,
+                                      bool *timeout);
+
+    // search the best tree with the misclassification error in nProcesses processes, or one per core when nProcesses
+    // is not positive. Each process searches the trees whose root tests its share of the attributes, the processes
+    // sharing the best error of the root in shared memory to bound each other. The output is the one of solve, with
+    // the tree of the best process, the total lattice size and the elapsed time. The cache of the solver is not used.
+    // POSIX systems only
+    string solveSharded(int nProcesses,
+                        int maxdepth,
+                        int minsup,
+                        bool infoGain,
+                        bool infoAsc,
+                        bool repeatSort,
+                        int timeLimit,
+                        float maxError);
+
+    DataManager *dataReader;
+
+    // whether the parallel searches read a replica of the data on the NUMA node of their thread, on a host of several
+    // nodes. Otherwise, they all read the bitsets of dataReader, wherever they lie
+    bool numaReplicas = true;
+
+private:
+
+    // keep the cache of the last search if it answers or bounds a search with these parameters, or start a new one
+    void prepareCache(int maxdepth, int minsup, float maxError);
+
+    // write the cache with the nodes of its solutions, without the pending ones
+    void writeCheckpoint(const string &path, const vector<Node> &pending);
+
+    // copy the data on each NUMA node, once, when the searches use replicas
+    void replicateData();
+
+    // data read by the threads of the node
+    DataManager *localData(int node);
+
+    // whether each leaf of the solution of the node covers at least minsup transactions
+    bool frequentTree(RCover *cover, Node node, int minsup);
+
+    ExpError *experror;
+    Trie<CountError> *trie = nullptr; // cache of the last search with the misclassification error
+    int trieMaxdepth = 0; // parameters of the search of the cache
+    int trieMinsup = 0;
+    bool trieComplete = false; // false when the solutions of the cache may not be optimal, as after a time limit
+    vector<int> lastTree; // best tree of the last search of the misclassification error, in preorder as the prior trees
+    mutex cacheMutex; // held by the calls reading or writing the cache and the members above
+    vector<DataManager *> replicas; // replica of the data on each NUMA node, empty until a parallel search needs them
+    mutex replicasMutex; // held by the calls reading or copying the replicas
+};
+
 //string search ( int argc, char *argv[], int* supports, int ntransactions, int nattributes, int nclasses, int *data, int *target, float maxError, bool stopAfterError, bool iterative );
 string search (//std::function<float(int*)> callback,
         //std::function<float(Array<int>::iterator)> callback,
@@ -43,6 +238,13 @@ string search (//std::function<float(int*)> callback,
         bool save = false,
         bool nps_param = false,
         bool verbose_param = false,
-        bool predict = false);
+        bool predict = false,
+        string error_plugin_path = "",
+        size_t error_plugin_address = 0,
+        bool anytime = false,
+        function<bool(string, float, float, float)> solution_callback = nullptr,
+        bool solution_is_null = true,
+        int *warm_tree = nullptr,
+        int warm_tree_size = 0);
 
 #endif //DL85_DL85_H
@@ -1,7 +1,10 @@
 from libcpp cimport bool
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 from libcpp.stack cimport stack
 from cython.operator cimport dereference as deref, preincrement as inc
+import numpy as np
+import json
 
 cdef extern from "dataManager.h":
     cdef cppclass DataManager:
@@ -18,8 +21,13 @@ cdef extern from "rCover.h":
             bool operator!=(iterator)
         iterator begin(bool trans_loop)
         iterator end(bool trans_loop)
+        int getTransactionsID()
+        int getCoverWords()
         DataManager* dm
         stack[int] limit
+        int* sup
+        int* tids
+        unsigned long long* words
 
 cdef class ArrayIterator:
     cdef RCover* arr
@@ -51,6 +59,31 @@ cdef class ArrayIterator:
     def init_iterator(self):
             self.it = self.arr.begin(self.trans_loop)
 
+    def to_array(self):
+        """Return the transactions ids (or the class supports for a fast error function) as a read-only
+        int32 numpy array. The array is a view on a buffer reused by the search: it is only valid during
+        the call of the error function and must be copied to be kept."""
+        cdef int n
+        if self.trans_loop:
+            n = self.arr.getTransactionsID()
+            if n == 0:
+                return np.empty(0, dtype=np.int32)
+            out = np.asarray(<int[:n]> self.arr.tids)
+        else:
+            n = deref(self.arr.dm).getNClasses()
+            out = np.asarray(<int[:n]> self.arr.sup)
+        out.setflags(write=False)
+        return out
+
+    def to_words(self):
+        """Return the cover as a read-only uint64 numpy array, transaction t being the bit t % 64 of the
+        word t // 64. The array is a view on a buffer reused by the search: it is only valid during the call
+        of the error function and must be copied to be kept."""
+        cdef int n = self.arr.getCoverWords()
+        out = np.asarray(<unsigned long long[:n]> self.arr.words).view(np.uint64)
+        out.setflags(write=False)
+        return out
+
 cdef public wrap_array(RCover *ar, bool trans):
     tid_python_object = ArrayIterator(trans)
     tid_python_object.arr = ar
@@ -66,3 +99,7 @@ cdef public vector[float] call_python_fast_error_function(python_fast_function,
 cdef public float call_python_predictor_error_function(python_predictor_function, RCover *ar):
     return python_predictor_function(wrap_array(ar, True))
 
+# an exception raised by the function is printed and the search goes on
+cdef public bool call_python_solution_function(python_solution_function, string tree, float error, float lower_bound,
+                                               float gap) noexcept with gil:
+    return python_solution_function(json.loads(tree.decode("utf-8")), error, lower_bound, gap)
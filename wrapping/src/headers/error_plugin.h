@@ -0,0 +1,43 @@
+#ifndef DL85_ERROR_PLUGIN_H
+#define DL85_ERROR_PLUGIN_H
+
+/*
+ * C interface of the error function plugins. A plugin is a DL85ErrorPlugin structure, either exported by a shared
+ * library under the name DL85_ERROR_PLUGIN_SYMBOL or built in memory (ctypes, numba.cfunc, ...) and given by address.
+ * Its functions are called directly by the search, without going through Python.
+ */
+
+#include <stdint.h>
+
+#define DL85_ERROR_PLUGIN_ABI_VERSION 1
+#define DL85_ERROR_PLUGIN_SYMBOL "dl85_error_plugin"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct DL85ErrorPlugin {
+    /* must be set to DL85_ERROR_PLUGIN_ABI_VERSION */
+    int abi_version;
+    /* if non zero, node_error and lower_bound receive the cover as words. Otherwise words is NULL */
+    int needs_cover;
+    /* opaque pointer given to init */
+    void *user_data;
+    /* called once before the search. The returned pointer is given as state to the other functions. May be NULL */
+    void *(*init)(void *user_data, int ntransactions, int nclasses, const int *class_supports);
+    /* error of a leaf on the cover. The predicted class must be written in prediction.
+     * transaction t of the cover is the bit t % 64 of words[t / 64]. supports[c] is the number of transactions of
+     * class c in the cover */
+    float (*node_error)(void *state, const uint64_t *words, int nwords, const int *supports, int nclasses,
+                        int *prediction);
+    /* lower bound of the error of any tree on the cover. May be NULL, in which case 0 is used */
+    float (*lower_bound)(void *state, const uint64_t *words, int nwords, const int *supports, int nclasses);
+    /* called once after the search to free the state. May be NULL */
+    void (*destroy)(void *state);
+} DL85ErrorPlugin;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DL85_ERROR_PLUGIN_H
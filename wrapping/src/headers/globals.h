@@ -10,10 +10,11 @@ typedef int Transaction;
 typedef int Attribute;
 typedef int Size; // size of a tree
 typedef int Depth;
-typedef float Error;
+typedef float Error; // error of the objectives given by a custom function
 typedef Attribute Item; // an item is an attribute and its binary value
 typedef Transaction Support;
 typedef Support *Supports;
+typedef Support CountError; // exact error of the objectives counting transactions, such as the misclassification
 
 #define NO_SUP INT_MAX // SHRT_MAX
 #define NO_ERR FLT_MAX
@@ -28,6 +29,8 @@ typedef Support *Supports;
 #include <iostream>
 #include <map>
 #include <iterator>
+#include <cmath>
+#include <algorithm>
 
 // the array is a light-weight vector that does not do copying or resizing of storage space.
 template<class A>
@@ -83,39 +86,59 @@ void addItem(Array<Item> src1, Item item, Array<Item> dest);
 
 #define forEach(i, a) for ( int i = 0; i < a.size; ++i )
 
+// the functions below take the number of classes as parameter: there is no global state so that several searches
+// can run concurrently
+
 // create (dynamic allocation of vector of size = number of classes)
-Supports newSupports();
+Supports newSupports(Class nclasses);
 
 // create (dynamic allocation of vector of size = number of classes) and fill vector of support with zeros
-Supports zeroSupports();
+Supports zeroSupports(Class nclasses);
 
 // fill vector of support with zeros
-void zeroSupports(Supports supports);
+void zeroSupports(Supports supports, Class nclasses);
 
 // free the memory
 void deleteSupports(Supports supports);
 
 // copy values of support array src to dest
-void copySupports(Supports src, Supports dest);
+void copySupports(Supports src, Supports dest, Class nclasses);
 
 // create support array dest, copy values of array in parameter in dest and return dest
-Supports copySupports(Supports supports);
+Supports copySupports(Supports supports, Class nclasses);
 
 // return sum of value of support
-Support sumSupports(Supports supports);
+Support sumSupports(Supports supports, Class nclasses);
 
 // return dest which is array of substraction of src2 from src1
-void minSupports(Supports src1, Supports src2, Supports dest);
+void minSupports(Supports src1, Supports src2, Supports dest, Class nclasses);
 
 // return dest which is array of addition of src2 from src1
-void plusSupports(Supports src1, Supports src2, Supports dest);
-
-extern Class nclasses;
-extern Attribute nattributes;
-extern std::map<int, int> attrFeat;
-extern bool nps;
-extern bool verbose;
-
-#define forEachClass(n) for ( Class n = 0; n < nclasses; ++n )
+void plusSupports(Supports src1, Supports src2, Supports dest, Class nclasses);
+
+#define forEachClass(n, nclasses) for ( Class n = 0; n < nclasses; ++n )
+
+// error of a node without solution, for each error type. The integer value leaves room to add two of them
+template<class E> inline E noError ();
+template<> inline Error noError<Error> () { return NO_ERR; }
+template<> inline CountError noError<CountError> () { return INT_MAX / 2; }
+
+// bound of the error type from a bound given by the user, such that the errors below both bounds are the same
+template<class E> inline E toError ( float bound );
+template<> inline Error toError<Error> ( float bound ) { return bound; }
+template<> inline CountError toError<CountError> ( float bound ) {
+    return bound >= (float) noError<CountError> () ? noError<CountError> () : (CountError) ceil ( bound );
+}
+
+// upper bound just above an error, under which a tree with this error is still found. The errors given by a custom
+// function get some slack, as they may be summed in another order
+template<class E> inline E boundAbove ( E error );
+template<> inline Error boundAbove<Error> ( Error error ) { return error + std::max ( std::fabs ( error ) * 1e-5f, 1e-5f ); }
+template<> inline CountError boundAbove<CountError> ( CountError error ) { return error + 1; }
+
+// upper bound left once error has been spent. The lack of bound is kept
+template<class E> inline E remainingBound ( E bound, E error ) {
+    return bound == noError<E> () ? bound : bound - error;
+}
 
 #endif
\ No newline at end of file
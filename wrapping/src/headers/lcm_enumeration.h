@@ -0,0 +1,78 @@
+#ifndef DL85_LCM_ENUMERATION_H
+#define DL85_LCM_ENUMERATION_H
+#include <string>
+#include <vector>
+#include "globals.h"
+#include "trie.h"
+#include "query.h"
+#include "dataManager.h"
+#include "rCover.h"
+
+using namespace std;
+
+// search of several trees instead of the best one. Each node of the cache keeps a list of its best subtrees, composed
+// at each split from the lists of its children, so that the list of the root gives the best trees of the data. The
+// lists keep the maxTrees best subtrees whose error is within epsilon of the best one: the k best trees or the
+// Rashomon set, maxTrees bounding the memory of each node. A subtree of one of these trees is among the best subtrees
+// of its node, as the trees keep their rank when a subtree is replaced by a better one. A test is only kept when it
+// is better than the leaf, as the other subtrees predict no better. No subtree is pruned by the errors, as the
+// subtrees not in the best tree may be in the others: the lattice is explored up to the maximum depth.
+// With pareto, the lists keep instead the Pareto front of the error and the number of leaves: the subtrees for which
+// no other one is as good on both and better on one. A subtree of a tree of the front is on the front of its node
+// likewise, so that the front of the root gives the best error of each size of tree. maxLeaves then bounds the number
+// of leaves of the trees: a subtree at depth d has at most maxLeaves - d leaves, as each test above it has another
+// branch with one leaf at least, so that the nodes left with a single leaf are not split
+template<class Query_>
+class LcmEnumeration {
+public:
+    typedef typename Query_::Error Error; // type of the errors of the search
+
+    // subtree of a node: a leaf, or a test whose subtrees are in the lists of the children
+    struct Solution {
+        Error error;
+        int leaves;
+        Attribute test; // -1 - class for a leaf
+        Node children[2]; // negative then positive child
+        int indices[2]; // index of the subtree in the list of each child
+    };
+
+    LcmEnumeration ( DataManager *dataReader, Query_ *query, Trie<Error> *trie, int maxTrees, float epsilon, bool pareto = false, int maxLeaves = 0 );
+
+    void run ();
+
+    // subtrees kept for the node, the best first. The trees of the same error go by their number of leaves, which
+    // decreases along a Pareto front
+    const vector<Solution> &solutions ( Node node ) const { return lists[node]; }
+
+    // subtree of the node in the format of Query_Best::printTree
+    string printTree ( Node node, int index );
+
+    int depth ( Node node, int index );
+
+    // write the subtree of the node in the cache as the solution of its nodes, as the search of the best tree does
+    void saveSolution ( Node node, int index );
+
+    Node root = NO_NODE;
+    int latticesize = 0;
+
+protected:
+    // explore the node of the itemset, whose cover is the current one, and return it
+    Node recurse ( vector<Item> &itemset, Depth depth );
+
+    // sort the candidate subtrees of a node and keep the ones of its list
+    void select ( vector<Solution> &candidates );
+
+    void printTree ( Node node, int index, string &out );
+
+    DataManager *dataReader;
+    Query_ *query;
+    Trie<Error> *trie;
+    int maxTrees;
+    float epsilon;
+    bool pareto;
+    int maxLeaves; // 0 without bound
+    RCover *cover = nullptr; // cover of the node being explored
+    vector<vector<Solution>> lists; // subtrees of each node of the cache, indexed by node
+};
+
+#endif //DL85_LCM_ENUMERATION_H
@@ -10,11 +10,19 @@
 #include "query.h"
 #include "dataManager.h"
 #include "rCover.h"
+#include "arena.h"
+#include "successor_cache.h"
 
 
+// the search is instantiated for each query type, so that the calls to the query are resolved at compile time.
+// Unlike LcmPruned, the search recurses, at most maxdepth + 1 calls deep, and runs to its end in one call: it cannot
+// stop between steps to be resumed later
+template<class Query_>
 class LcmIterative {
 public:
-    LcmIterative ( DataManager *data, Query *query, Trie *trie, bool infoGain, bool infoAsc, bool allDepths );
+    typedef typename Query_::Error Error; // type of the errors and bounds of the search
+
+    LcmIterative ( DataManager *data, Query_ *query, Trie<Error> *trie, bool infoGain, bool infoAsc, bool allDepths );
 
     ~LcmIterative();
 
@@ -24,28 +32,60 @@ public:
 
 
 protected:
-    TrieNode* recurse ( Array<Item> itemset,
+    Node recurse ( Array<Item> itemset,
                         Item added,
                         Array<pair<bool,Attribute> > a_attributes,
                         RCover* a_transactions,
                         Depth depth,
-                        float priorUbFromParent,
+                        Error priorUbFromParent,
                         int currentMaxDepth);
 
     Array<pair<bool,Attribute>> getSuccessors(Array<pair<bool,Attribute > > a_attributes,
                                               RCover* a_transactions,
-                                              Item added);
+                                              Item added,
+                                              Depth depth);
+
+    // keep the solution of the node for the depth it was last searched with, before it is searched with a larger one
+    void saveSolution ( Node node, Depth depth );
+
+    // put back in the cache the tree found by the iteration with the given maximum depth
+    void restoreSolution ( Node node, Depth depth, Depth maxDepth );
+
+    // whether the last search of the node did not depend on the maximum depth, so that its result, a tree or no tree
+    // better than its bound, holds for the larger ones
+    bool settled ( Node node ) const { return node < settledDepths.size() && settledDepths[node] > 0; }
+
+    // record whether the search of the node with the given maximum depth did not depend on it
+    void setSettled ( Node node, bool settled, Depth maxDepth );
 
     void printItemset(Array<Item> itemset);
 
     float informationGain ( pair<Supports,Support> notTaken, pair<Supports,Support> taken);
 
     DataManager *dataReader;
-    Trie *trie;
-    Query *query;
+    Query_ *query;
+    Trie<Error> *trie;
     bool infoGain = false;
     bool infoAsc = false; //if true ==> items with low IG are explored first
     bool allDepths = false;
+    SearchBuffers *buffers = nullptr; // itemsets, successors and supports of the nodes being explored
+    SuccessorCache *successorCache = nullptr; // successors of the nodes which may be searched again
+
+    // solution of a node for one maximum depth of the iterative deepening
+    struct DepthSolution {
+        Error error;
+        Error initUb;
+        Node left;
+        Node right;
+        Attribute test;
+        Size size; // 0 when the node was not searched with this depth
+    };
+
+    Arena solutionArena;
+    vector<DepthSolution*> solutions; // for each node searched with several depths, its solutions by remaining depth
+    // for each node, the maximum depth from which its solution no longer depends on it, 0 while it does. The
+    // next iterations do not search these nodes again
+    vector<int16_t> settledDepths;
     //bool timeLimitReached = false;
 };
 
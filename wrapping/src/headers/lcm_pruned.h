@@ -6,35 +6,109 @@
 #include "query.h"
 #include "dataManager.h"
 #include "rCover.h"
+#include "arena.h"
+#include "successor_cache.h"
 
+// the search is instantiated for each query type, so that the calls to the query are resolved at compile time.
+// the depth first search does not recurse: the nodes of the current branch are kept in a stack of frames, one per
+// depth, allocated once. The whole state of the search is thus in the engine, which can stop after a number of steps
+// and resume later
+template<class Query_>
 class LcmPruned {
 public:
-    LcmPruned ( DataManager *dataReader, Query *query, Trie *trie, bool infoGain, bool infoAsc, bool allDepths );
+    typedef typename Query_::Error Error; // type of the errors and bounds of the search
+
+    LcmPruned ( DataManager *dataReader, Query_ *query, Trie<Error> *trie, bool infoGain, bool infoAsc, bool allDepths );
 
     ~LcmPruned();
 
     void run ();
 
+    /// open the root of the search. The search is then explored with resume
+    void start ();
+
+    /// explore the search for at most maxSteps steps, or until the end if maxSteps is negative. Return true when the
+    /// search is complete
+    bool resume ( long maxSteps = -1 );
+
+    /// nodes of the current branch, whose solutions are not final while the search is paused between two steps
+    vector<Node> pendingNodes () const;
+
     int latticesize = 0;
 
 
 protected:
-    TrieNode* recurse ( Array<Item> itemset, Item added, Array<pair<bool,Attribute>> a_attributes, RCover* a_transactions, Depth depth, float priorUbFromParent );
+    // what remains to do on the attribute of a frame being explored
+    enum FrameState { NEXT_ATTRIBUTE, LEFT_EXPLORED, RIGHT_EXPLORED, ATTRIBUTE_EXPLORED };
+
+    // node of the current branch whose children are being explored
+    struct Frame {
+        Node node;
+        Array<Item> itemset;
+        Array<pair<bool,Attribute>> attributes; // successors of the node
+        int i; // index of the attribute being explored
+        int count; // number of attributes explored
+        Error ub; // upper bound of the error of the node, improved by each solution found
+        Error initUb;
+        Error parentUb;
+        Node left; // left child of the attribute being explored
+        FrameState state;
+        int warm; // node of the prior tree with the same itemset, or -1
+        bool lastTreeAboveBound; // whether the node keeps the tree of a smaller depth, worse than parentUb
+    };
+
+    // node of the prior tree of a warm start
+    struct WarmNode {
+        Attribute test; // -1 for a leaf
+        int positive; // children in warmNodes
+        int negative;
+        Error error; // error of the subtree on the data, which bounds the node with the itemset of its path
+    };
+
+    // get the node of the itemset of the parent frame with the added item. The node is stored in returned and, when
+    // its children must be explored, a frame is pushed for it
+    void open ( Depth depth, Item added, Error parent_ub );
+
+    // the children of the frame have been explored
+    void close ( Frame &frame, Depth depth );
+
+    // error of a tree built greedily on the cover: the splits maximize the information gain, except the last ones
+    // which minimize the error. It bounds the error of the optimal tree
+    Error greedyError ( Depth depth );
+
+    // read the node of the prior tree starting at pos in query->warmTree and its subtrees. Return its index
+    int readWarmTree ( size_t &pos );
+
+    // error of the subtree of the prior tree on the cover, cut at the maximum depth and where a branch is not frequent.
+    // The errors of the nodes of the subtree are stored as well
+    Error warmError ( int warm, Depth depth );
+
+    // the greedy trees bound the search only for the error functions where a split never costs more than the leaf:
+    // the search splits a node above the maximum depth whenever it can, even when the leaf is better
+    bool useGreedyBound () const { return Query_::greedyBound; }
 
-    Array<pair<bool,Attribute>> getSuccessors(Array<pair<bool,Attribute > > a_attributes,RCover* a_transactions, Item added);
+    Array<pair<bool,Attribute>> getSuccessors(Array<pair<bool,Attribute > > a_attributes,RCover* a_transactions, Item added, Depth depth);
 
-    Array<pair<bool, Attribute> > getExistingSuccessors(TrieNode* node);
+    Array<pair<bool, Attribute> > getExistingSuccessors(Node node);
 
     void printItemset(Array<Item> itemset);
 
     float informationGain ( pair<Supports,Support> notTaken, pair<Supports,Support> taken);
 
     DataManager *dataReader;
-    Trie *trie;
-    Query *query;
+    Query_ *query;
+    Trie<Error> *trie;
     bool infoGain = false;
     bool infoAsc = false; //if true ==> items with low IG are explored first
     bool allDepths = false;
+    SearchBuffers *buffers = nullptr; // itemsets, successors and supports of the nodes being explored
+    RCover *cover = nullptr; // cover of the node of the top frame
+    SuccessorCache *successorCache = nullptr; // successors of the nodes without solution, which may be searched again
+    Array<pair<bool,Attribute>> rootAttributes = Array<pair<bool,Attribute>>(nullptr, 0); // candidate attributes of the root
+    Frame *frames = nullptr; // frames of the current branch, indexed by depth
+    int top = -1; // depth of the top frame, -1 when the search is complete
+    Node returned = NO_NODE; // node of the last child explored
+    vector<WarmNode> warmNodes; // prior tree of a warm start, its root first
     //bool timeLimitReached = false;
 };
 
@@ -12,20 +12,21 @@ using namespace std;
 class Logger {
 
 public:
-    //static const bool enable = false;
+    // set at the beginning of each search. Thread local as each search runs in its own thread
+    static thread_local bool enable;
     static void writeConsole(string s);
     static void writeConsoleAndReturn(string s);
 
     template<typename T>
     static void showMessageAndReturn(T &&t) {
-        if (verbose){
+        if (enable){
             std::cout << t << "\n";
         }
     }
 
     template<typename Head, typename... Tail>
     static void showMessageAndReturn(Head &&head, Tail&&... tail) {
-        if (verbose){
+        if (enable){
             std::cout << head;
             showMessageAndReturn(std::forward<Tail>(tail)...);
         }
@@ -33,14 +34,14 @@ public:
 
     template<typename T>
     static void showMessage(T &&t) {
-        if (verbose){
+        if (enable){
             std::cout << t;
         }
     }
 
     template<typename Head, typename... Tail>
     static void showMessage(Head &&head, Tail&&... tail) {
-        if (verbose){
+        if (enable){
             std::cout << head;
             showMessage(std::forward<Tail>(tail)...);
         }
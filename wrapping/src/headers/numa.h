@@ -0,0 +1,15 @@
+#ifndef DL85_NUMA_H
+#define DL85_NUMA_H
+
+#include <vector>
+
+using namespace std;
+
+/// cpus of each NUMA node of the host, read once from /sys/devices/system/node on Linux. A single node without cpus
+/// when the topology is unknown, as on the other systems
+const vector<vector<int>>& numaNodes();
+
+/// bind the calling thread to the cpus. false when the binding is not supported or refused
+bool pinThread(const vector<int>& cpus);
+
+#endif //DL85_NUMA_H
@@ -0,0 +1,38 @@
+#ifndef DL85_PLUGIN_ERROR_FUNCTION_H
+#define DL85_PLUGIN_ERROR_FUNCTION_H
+
+#include <string>
+#include "globals.h"
+#include "error_plugin.h"
+#include "rCover.h"
+
+using namespace std;
+
+/// owns a DL85ErrorPlugin loaded from a shared library or given by address, and its state during a search
+class ErrorPlugin {
+public:
+    /// load the plugin exported by the shared library at path. Throws runtime_error on failure
+    static ErrorPlugin* load(const string& path);
+
+    /// use the plugin structure located at address (e.g. built with ctypes). Throws runtime_error on failure
+    static ErrorPlugin* fromAddress(size_t address);
+
+    ~ErrorPlugin();
+
+    /// call the init function of the plugin. Must be called once before the search
+    void init(DataManager* dm);
+
+    /// return the error of the leaf on the current cover and write its predicted class and the lower bound of the error
+    Error nodeError(RCover* cover, Supports supports, Class* prediction, Error* lowerBound);
+
+private:
+    ErrorPlugin(DL85ErrorPlugin* plugin, void* library);
+
+    DL85ErrorPlugin* plugin;
+    void* library; /// handle of the shared library, nullptr if the plugin was given by address
+    void* state = nullptr;
+    int nclasses = 0;
+    bool initialized = false;
+};
+
+#endif //DL85_PLUGIN_ERROR_FUNCTION_H
@@ -0,0 +1,54 @@
+#ifndef DL85_PY_SOLUTION_CALLBACK_WRAPPER_H
+#define DL85_PY_SOLUTION_CALLBACK_WRAPPER_H
+
+#include <Python.h>
+#include <string>
+#include "error_function.h" // cython helper file
+
+// python function called with each improving solution of the search. The helper takes the GIL itself, so that it
+// can be called from a search which released it
+class PySolutionWrapper {
+public:
+    // constructors and destructors mostly do reference counting
+    PySolutionWrapper(PyObject* o): pySolutionFunction(o) {
+        Py_XINCREF(o);
+    }
+
+    PySolutionWrapper(const PySolutionWrapper& rhs): PySolutionWrapper(rhs.pySolutionFunction) { // C++11 onwards only
+    }
+
+    PySolutionWrapper(PySolutionWrapper&& rhs): pySolutionFunction(rhs.pySolutionFunction) {
+        rhs.pySolutionFunction = 0;
+    }
+
+    // need no-arg constructor to stack allocate in Cython
+    PySolutionWrapper(): PySolutionWrapper(nullptr) {
+    }
+
+    ~PySolutionWrapper() {
+        Py_XDECREF(pySolutionFunction);
+    }
+
+    PySolutionWrapper& operator=(const PySolutionWrapper& rhs) {
+        PySolutionWrapper tmp = rhs;
+        return (*this = std::move(tmp));
+    }
+
+    PySolutionWrapper& operator=(PySolutionWrapper&& rhs) {
+        pySolutionFunction = rhs.pySolutionFunction;
+        rhs.pySolutionFunction = 0;
+        return *this;
+    }
+
+    bool operator()(std::string tree, float error, float lowerBound, float gap) {
+        PyInit_error_function();
+        if (pySolutionFunction) // nullptr check
+            return call_python_solution_function(pySolutionFunction, tree, error, lowerBound, gap);
+        return false;
+    }
+
+private:
+    PyObject* pySolutionFunction;
+};
+
+#endif //DL85_PY_SOLUTION_CALLBACK_WRAPPER_H
@@ -4,49 +4,67 @@
 #include "globals.h"
 #include "rCover.h"
 #include "dataManager.h"
+#include "trie.h"
 #include <iostream>
 #include <cfloat>
 #include <functional>
 #include <vector>
+#include <chrono>
 
-struct TrieNode;
-class Trie;
+class ErrorPlugin;
 
 using namespace std;
 
-typedef void *QueryData; // using void pointers is much lighter than class derivation
-
-
 
 class Query {
 public:
-    Query( Trie * trie, DataManager *data, int timeLimit, bool continuous, function<vector<float>(RCover*)>* error_callback = nullptr, function<vector<float>(RCover*)>* fast_error_callback = nullptr, function<float(RCover*)>*  predictor_error_callback = nullptr, float maxError = NO_ERR, bool stopAfterError = false );
+    Query( DataManager *data, int timeLimit, bool continuous, function<vector<float>(RCover*)>* error_callback = nullptr, function<vector<float>(RCover*)>* fast_error_callback = nullptr, function<float(RCover*)>*  predictor_error_callback = nullptr, float maxError = NO_ERR, bool stopAfterError = false );
 
     virtual ~Query();
     virtual bool is_freq ( pair<Supports,Support> supports ) = 0;
     virtual bool is_pure ( pair<Supports,Support> supports ) = 0;
-    virtual bool canimprove ( QueryData *left, Error ub ) = 0;
-    virtual bool canSkip ( QueryData *actualBest ) = 0;
-    //virtual QueryData *initData ( Array<Transaction> tid, Error parent_ub, Support minsup, Depth currentMaxDepth = -1) = 0;
-    virtual QueryData *initData ( RCover* tid, Error parent_ub, Support minsup, Depth currentMaxDepth = -1) = 0;
-    virtual bool updateData ( QueryData *best, Error upperBound, Attribute attribute, QueryData *left, QueryData *right ) = 0;
     virtual string printResult ( DataManager *data ) = 0;
-    void setStartTime( clock_t sTime ){startTime = sTime;}
+    void setStartTime(){startTime = chrono::steady_clock::now();}
+    // seconds elapsed since the start of the search. Wall time, as the CPU time of the process counts the searches of
+    // the other threads
+    float runTime() const {return chrono::duration<float>(chrono::steady_clock::now() - startTime).count();}
 
     DataManager *data; // we need to have information about the data for default predictions
-    Trie *trie;
-    TrieNode *realroot; // as the empty itemset may not have an empty closure
     Support minsup;
     Depth maxdepth;
-    clock_t startTime;
+    chrono::steady_clock::time_point startTime;
     int timeLimit;
     bool timeLimitReached = false;
     bool continuous = false;
     float maxError = NO_ERR;
     bool stopAfterError = false;
+    bool nps = false; // if true, only optimal solutions are reused from the cache
     function<vector<float>(RCover*)>* error_callback;
     function<vector<float>(RCover*)>* fast_error_callback;
     function<float(RCover*)>*  predictor_error_callback;
+    ErrorPlugin* error_plugin = nullptr; // native error function used instead of the misclassification error
+    // called with the tree, the error, the lower bound and the relative gap of each solution improving the root. The
+    // search stops when it returns true
+    function<bool(string, float, float, float)>* solution_callback = nullptr;
+    // prior tree of a warm start in preorder: the attribute of each test followed by its positive then its negative
+    // subtree, -1 for a leaf. Empty without prior tree
+    vector<Attribute> warmTree;
+    // when set, the iterative search appends the result of each depth it completes, as printed at the end of a search
+    vector<string>* depthResults = nullptr;
+    // transactions the search learns from, all of them when null. The mask has the layout of the columns of the data
+    const bitset<M>* trainingMask = nullptr;
+    // class supports of these transactions, which break the ties between the classes of the leaves
+    Supports classSupports;
+    // attributes the trees may test, all of them when empty
+    vector<Attribute> attributes;
+    // weights of the transactions for the weighted misclassification error, transaction t weighing weights[t]
+    const float* weights = nullptr;
+    vector<float> classWeights; // weight of each class in the cover of the node being initialized, reused
+    // attributes the root may test, indexed by attribute, all the candidates when empty. The other nodes test all of
+    // them, so that the searches of several shards of the root attributes cover all the trees
+    vector<bool> rootTests;
+    // best error found for the root by other searches, read before each attribute of the root. Null when alone
+    function<float()>* rootBound = nullptr;
 };
 
 #endif
\ No newline at end of file
@@ -2,38 +2,44 @@
 #define QUERY_BEST_H
 #include "trie.h"
 #include "experror.h"
+#include "logger.h"
 #include <query.h>
 #include <vector>
 
-struct QueryData_Best {
-  Attribute test;
-  QueryData_Best *left, *right;
-  Error leafError;
-  Error error;
-  Error initUb = NO_ERR;
-  Error lowerBound;
-  Size size;
-  Depth solutionDepth;
-  //Array<pair<bool,Attribute> > successors = nullptr;
-};
-
-
+// E is the type of the errors of the nodes
+template<class E>
 class Query_Best : public Query {
 public:
-    Query_Best ( Trie *trie, DataManager *data, ExpError *experror, int timeLimit, bool continuous, function<vector<float>(RCover*)>* error_callback = nullptr, function<vector<float>(RCover*)>* fast_error_callback = nullptr, function<float(RCover*)>*  predictor_error_callback = nullptr, float maxError = NO_ERR, bool stopAfterError = false );
+    typedef E Error;
+
+    Query_Best ( Trie<E> *trie, DataManager *data, ExpError *experror, int timeLimit, bool continuous, function<vector<float>(RCover*)>* error_callback = nullptr, function<vector<float>(RCover*)>* fast_error_callback = nullptr, function<float(RCover*)>*  predictor_error_callback = nullptr, float maxError = NO_ERR, bool stopAfterError = false );
 
     virtual ~Query_Best ();
-    bool canimprove ( QueryData *left, Error ub );
-    bool canSkip ( QueryData *actualBest);
+    // defined here so that they are inlined in the search engines
+    bool canimprove ( Node left, Error ub ) {
+        return trie->error(left) < ub ;
+    }
+    bool canSkip ( Node actualBest ) {
+        Logger::showMessageAndReturn("checking canSkip");
+        return trie->error(actualBest) <= trie->lowerBound(actualBest);
+    }
     string printResult ( DataManager *data );
     virtual void printTimeOut(string*);
-    string printResult ( DataManager *data2, QueryData_Best *data );
-    virtual void printAccuracy ( DataManager *data2, QueryData_Best *data, string* );
+    string printResult ( DataManager *data2, Node node );
+    // the tree below the node alone, as printed in the results
+    string printTree ( Node node );
+    virtual void printAccuracy ( DataManager *data2, Node node, string* );
     //virtual Class runResult ( DataManager *data, Transaction transaction );
-    //virtual Class runResult ( QueryData_Best *node, DataManager *data, Transaction transaction );
-    QueryData_Best *rootBest () const { return (QueryData_Best*) realroot->data; }
+    //virtual Class runResult ( Node node, DataManager *data, Transaction transaction );
+    Node rootBest () const { return realroot; }
+    // give the new best solution of the root to the solution callback, with the lower bound of the optimal error.
+    // Return true if the search must stop
+    bool publishSolution ( Node node, E lowerBound );
+
+    Trie<E> *trie;
+    Node realroot; // as the empty itemset may not have an empty closure
 protected:
-    int printResult ( QueryData_Best *node, int depth, string* );
+    int printResult ( Node node, int depth, string* );
     ExpError *experror;
 };
 
@@ -2,21 +2,208 @@
 #define QUERY_TOTALFREQ_H
 #include <query_best.h>
 #include <vector>
+#include "plugin_error_function.h"
 
+// error functions of Query_TotalFreq. leafError returns the error of a leaf on the current cover and writes its
+// predicted class and the lower bound of the error of any tree on the cover. The function is chosen once per search,
+// so that the search engines instantiated with it call it without indirection. Error is the type in which the search
+// stores and compares the errors: integer for the objectives counting transactions, so that the comparisons stay
+// exact whatever the number of transactions. greedyBound tells whether a split never costs more than the leaf, so that
+// the error of a greedy tree, which splits wherever it can as the search does, bounds the error of the optimal tree
 
-class Query_TotalFreq : public Query_Best {
+// misclassification error, the default objective
+struct MisclassificationError {
+    typedef CountError Error;
+    static const bool greedyBound = true;
+
+    static Error leafError(Query_Best<Error> *query, RCover *cover, Supports supports, Class *prediction, Error *lowerBound) {
+        pair <Supports, Support> itemsetSupport = cover->getSupportPerClass(supports);
+        cover->sup = itemsetSupport.first;
+        DataManager *data = query->data;
+
+        Support maxclassval = itemsetSupport.first[0];
+        Class maxclass = 0;
+        int secondval = -1;
+        for (int i = 1; i < data->getNClasses(); ++i) {
+            if (itemsetSupport.first[i] > maxclassval) {
+                if (maxclassval > secondval)
+                    secondval = maxclassval;
+                maxclassval = itemsetSupport.first[i];
+                maxclass = i;
+            } else if (itemsetSupport.first[i] == maxclassval) {
+                secondval = maxclassval;
+                if (query->classSupports[i] > query->classSupports[maxclass])
+                    maxclass = i;
+            } else{
+                if (itemsetSupport.first[i] > secondval)
+                    secondval = itemsetSupport.first[i];
+            }
+
+        }
+        *prediction = maxclass;
+        int supportForWarm = cover->getSupportForWarm();
+        if (supportForWarm == -1) {
+            *lowerBound = 0;
+        } else {
+            *lowerBound = itemsetSupport.second - supportForWarm;
+            Logger::showMessageAndReturn("lowerBound warm: ", *lowerBound);
+        }
+        return itemsetSupport.second - maxclassval;
+    }
+};
+
+// native error function of a plugin
+struct PluginError {
+    typedef ::Error Error;
+    static const bool greedyBound = false;
+
+    static Error leafError(Query_Best<Error> *query, RCover *cover, Supports supports, Class *prediction, Error *lowerBound) {
+        pair <Supports, Support> itemsetSupport = cover->getSupportPerClass(supports);
+        cover->sup = itemsetSupport.first;
+        return query->error_plugin->nodeError(cover, itemsetSupport.first, prediction, lowerBound);
+    }
+};
+
+// misclassification error where each transaction counts for its weight, as in the rounds of a boosting
+struct WeightedError {
+    typedef ::Error Error;
+    static const bool greedyBound = true;
+
+    static Error leafError(Query_Best<Error> *query, RCover *cover, Supports /*supports*/, Class *prediction, Error *lowerBound) {
+        vector<float> &classWeights = query->classWeights;
+        classWeights.resize(query->data->getNClasses());
+        float total = cover->getWeightedSupportPerClass(query->weights, classWeights.data());
+        Class maxclass = 0;
+        for (int i = 1; i < query->data->getNClasses(); ++i)
+            if (classWeights[i] > classWeights[maxclass] || (classWeights[i] == classWeights[maxclass] && query->classSupports[i] > query->classSupports[maxclass]))
+                maxclass = i;
+        *prediction = maxclass;
+        *lowerBound = 0;
+        return total - classWeights[maxclass];
+    }
+};
+
+// error function written in Python: fast error on the class supports, slow error on the transactions or error of
+// a user predictor
+struct CallbackError {
+    typedef ::Error Error;
+    static const bool greedyBound = false;
+
+    static Error leafError(Query_Best<Error> *query, RCover *cover, Supports supports, Class *prediction, Error *lowerBound) {
+        *lowerBound = 0;
+        if (query->predictor_error_callback != nullptr) {
+            function<float(RCover * )> callback = *query->predictor_error_callback;
+            return callback(cover);
+        }
+        if (query->error_callback == nullptr) // fast error. supports will be used
+            cover->sup = cover->getSupportPerClass(supports).first;
+        function < vector<float>(RCover * ) > callback = query->error_callback != nullptr ? *query->error_callback : *query->fast_error_callback;
+        vector<float> infos = callback(cover);
+        *prediction = int(infos[1]);
+        return infos[0];
+    }
+};
+
+
+template<class ErrorFunction>
+class Query_TotalFreq final : public Query_Best<typename ErrorFunction::Error> {
 public:
-    Query_TotalFreq( Trie *trie, DataManager *data, ExpError *experror, int timeLimit, bool continuous, function<vector<float>(RCover*)>* error_callback = nullptr, function<vector<float>(RCover*)>* fast_error_callback = nullptr, function<float(RCover*)>*  predictor_error_callback = nullptr, float maxError = NO_ERR, bool stopAfterError = false );
-
-    ~Query_TotalFreq();
-    bool is_freq ( pair<Supports,Support> supports );
-    bool is_pure ( pair<Supports,Support> supports );
-    bool updateData ( QueryData *best, Error upperBound, Attribute attribute, QueryData *left, QueryData *right);
-    QueryData *initData ( RCover* tid, Error initBound, Support minsup, Depth currentMaxDepth = -1);
-    //QueryData *initData ( Array<Transaction> tid, Error initBound, Support minsup, Depth currentMaxDepth = -1);
-    void printAccuracy ( DataManager *data2, QueryData_Best *data, string* );
+    typedef typename ErrorFunction::Error Error;
+    static const bool greedyBound = ErrorFunction::greedyBound;
+    using Query_Best<Error>::trie;
+    using Query_Best<Error>::data;
+    using Query_Best<Error>::minsup;
+    using Query_Best<Error>::experror;
+
+    Query_TotalFreq( Trie<Error> *trie, DataManager *data, ExpError *experror, int timeLimit, bool continuous, function<vector<float>(RCover*)>* error_callback = nullptr, function<vector<float>(RCover*)>* fast_error_callback = nullptr, function<float(RCover*)>*  predictor_error_callback = nullptr, float maxError = NO_ERR, bool stopAfterError = false )
+            : Query_Best<Error>(trie, data, experror, timeLimit, continuous, error_callback, fast_error_callback,
+                         predictor_error_callback, maxError, stopAfterError) {
+        supports = zeroSupports(data->getNClasses());
+    }
+
+    ~Query_TotalFreq() {
+        deleteSupports(supports);
+    }
+
+    bool is_freq ( pair<Supports,Support> supports ) {
+        return supports.second >= minsup;
+    }
+
+    bool is_pure ( pair<Supports,Support> supports ) {
+        Support majnum = supports.first[0], secmajnum = 0;
+        for (int i = 1; i < data->getNClasses(); ++i)
+            if (supports.first[i] > majnum) {
+                secmajnum = majnum;
+                majnum = supports.first[i];
+            } else if (supports.first[i] > secmajnum)
+                secmajnum = supports.first[i];
+        return ((long int) minsup - (long int) (supports.second - majnum)) > (long int) secmajnum;
+    }
+
+    bool updateData ( Node best, Error upperBound, Attribute attribute, Node left, Node right) {
+        Error error = trie->error(left) + trie->error(right);
+        Size size = trie->size(left) + trie->size(right) + 1;
+        if (error < upperBound || (error == upperBound && size < trie->size(best))) {
+            trie->error(best) = error;
+            trie->left(best) = left;
+            trie->right(best) = right;
+            trie->size(best) = size;
+            trie->test(best) = attribute;
+            return true;
+        }
+        return false;
+    }
+
+    // error of a leaf on the cover, with the lower bound of the error of any tree on it
+    Error leafError ( RCover* cover, Error *lowerBound ) {
+        Class maxclass = -1;
+        return ErrorFunction::leafError(this, cover, supports, &maxclass, lowerBound);
+    }
+
+    // lower bound of the optimal error of the root, whose tree is the best of its attributes before next. Each of the
+    // next ones splits the root into two children bounded by their lower bounds, or by their errors when leaves
+    Error rootLowerBound ( Node root, RCover* cover, Array<pair<bool,Attribute>> attributes, int next, bool leaves ) {
+        Error bound = trie->error(root);
+        for (int i = next; i < attributes.size && bound > trie->lowerBound(root); ++i) {
+            Attribute attribute = attributes[i].second;
+            if (!attributes[i].first || (!this->rootTests.empty() && !this->rootTests[attribute]))
+                continue;
+            Error split = 0;
+            for (int value = 0; value < 2; ++value) {
+                Error lowerBound = 0;
+                cover->intersect(attribute, value);
+                Error error = leafError(cover, &lowerBound);
+                cover->backtrack();
+                split += leaves ? error : lowerBound;
+            }
+            bound = min(bound, split);
+        }
+        return max(bound, trie->lowerBound(root));
+    }
+
+    void initData ( Node node, RCover* cover, Error parent_ub, Depth currentMaxDepth = -1) {
+        Class maxclass = -1;
+        Error lowerb = 0;
+        Error error = ErrorFunction::leafError(this, cover, supports, &maxclass, &lowerb);
+
+        trie->setHasData(node);
+        trie->test(node) = maxclass;
+        trie->left(node) = trie->right(node) = NO_NODE;
+        trie->leafError(node) = error;
+        trie->error(node) = noError<Error>();
+        trie->error(node) += (Error) experror->addError(cover->getSupport(), trie->error(node), data->getNTransactions());
+        trie->size(node) = 1;
+        trie->initUb(node) = parent_ub;
+        trie->setSolutionDepth(node, currentMaxDepth);
+        trie->lowerBound(node) = lowerb;
+    }
+
+    void printAccuracy ( DataManager *data2, Node node, string* out ) {
+        *out += "Accuracy: " + std::to_string((data2->getNTransactions() - trie->error(node)) / (double) data2->getNTransactions()) + "\n";
+    }
+
 protected:
-    int printResult ( TrieNode *node, int depth, string* );
+    Supports supports; // class supports of the node being initialized, reused between nodes
 };
 
-#endif
\ No newline at end of file
+#endif
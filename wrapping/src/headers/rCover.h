@@ -12,40 +12,81 @@
 #include <utility>
 #include "globals.h"
 #include "dataManager.h"
+#include "arena.h"
 #include <cmath>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 using namespace std;
 
 #define M 64
 
+// position of the lowest set bit of a non-zero word
+inline int lowestSetBit(unsigned long long word) {
+#if defined(_MSC_VER)
+    unsigned long pos;
+    _BitScanForward64(&pos, word);
+    return (int) pos;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
 class RCover {
 
 public:
-    stack<bitset<M>>* coverWords;
+    BitsetBlock* coverBlock; /// memory of coverWords
+    bitset<M>* coverWords; /// words of the cover at each depth of intersection, those of depth d from d * stride
     int* validWords;
     stack<int> limit;
     int nWords;
+    int stride; /// words of a depth in coverWords, rounded up to a cache line
+    int depth = 0; /// number of intersections of the current cover
+    int capacity; /// depths held by coverWords
     DataManager* dm;
     int* sup = nullptr;
+    Transaction* tids; /// scratch buffer filled by getTransactionsID and getClassTransactionsID. Reused between calls
+    unsigned long long* words; /// scratch buffer filled by getCoverWords. Reused between calls
 
-    RCover(DataManager* dmm);
+    /// cover of the transactions of the mask, of all the transactions without mask. The mask has the layout of the
+    /// columns of the data
+    RCover(DataManager* dmm, const bitset<M>* mask = nullptr);
 
     ~RCover(){
-        delete[] coverWords;
+        delete coverBlock;
         delete[] validWords;
+        delete[] tids;
+        delete[] words;
     }
 
     void intersect(Attribute attribute, bool positive = true);
 
+    /// word of index word of the current cover. Only the words among the first limit.top() of validWords are kept up to
+    /// date, the others being empty
+    bitset<M>& top(int word) { return coverWords[(size_t) depth * stride + word]; }
+
     int getSupport();
 
-    pair<Supports, Support> getSupportPerClass();
+    /// write the support of each class of the current cover in supports and return it with the total support
+    pair<Supports, Support> getSupportPerClass(Supports supports);
+
+    /// write the sum of the weights of the transactions of each class of the current cover in supports, transaction
+    /// t weighing weights[t], and return their total
+    float getWeightedSupportPerClass(const float* weights, float* supports);
 
     Support getSupportForWarm();
 
     int* getClassSupport();
 
-    vector<int> getTransactionsID();
+    /// write the ids of the transactions of the current cover in tids and return their number
+    int getTransactionsID();
+
+    /// write the ids of the transactions of the current cover in the class in tids and return their number
+    int getClassTransactionsID(Class clas);
+
+    /// write the current cover in words, transaction t being bit t%M of words[t/M], and return nWords
+    int getCoverWords();
 
     void backtrack();
 
@@ -70,7 +111,7 @@ public:
                     pos = 0;
                     transInd = 0;
                     first = true;
-                    word = container->coverWords[container->validWords[0]].top();
+                    word = container->top(container->validWords[0]);
                     setNextTransID();
                 }
 
@@ -87,15 +128,15 @@ public:
 
         explicit iterator() : wordIndex(-1), container(nullptr) {}
 
-        int getFirstSetBitPos(long n)
+        int getFirstSetBitPos(const bitset<M>& n)
         {
-            return log2(n & -n) + 1;
+            return n.none() ? 0 : lowestSetBit(n.to_ullong()) + 1;
         }
 
         void setNextTransID() {
             if (wordIndex < container->limit.top()) {
                 int indexForTransactions = container->nWords - (container->validWords[wordIndex]+1);
-                int pos = getFirstSetBitPos(word.to_ulong());
+                int pos = getFirstSetBitPos(word);
 
                 if (pos >= 1){
                     if (first){
@@ -112,7 +153,7 @@ public:
                     transInd = 0;
                     first = true;
                     if (wordIndex < container->limit.top()){
-                        word = container->coverWords[container->validWords[wordIndex]].top();
+                        word = container->top(container->validWords[wordIndex]);
                         setNextTransID();
                     }
                 }
@@ -179,6 +220,10 @@ public:
         return iterator(this, -1, trans_loop);
     }
 
+private:
+    /// double the depths held by coverWords
+    void grow();
+
 };
 
 
@@ -0,0 +1,44 @@
+#ifndef DL85_SUCCESSOR_CACHE_H
+#define DL85_SUCCESSOR_CACHE_H
+
+#include <vector>
+#include <cstdint>
+#include "globals.h"
+#include "arena.h"
+#include "trie.h"
+
+using namespace std;
+
+/// default memory of the successor lists of a search, in bytes
+const size_t SUCCESSOR_CACHE_CAPACITY = (size_t) 256 << 20;
+
+/// successor lists of the nodes of the cache which may be searched again, so that they are not computed again when
+/// the node is revisited. A list is stored as its number of attributes followed by the attributes, each shifted left
+/// with its flag in the low bit, in an array of power-of-two capacity drawn from an arena. Released arrays are reused
+/// for other nodes. When the memory of the arena reaches the capacity, the lists which do not fit are not stored and
+/// the search computes them again
+class SuccessorCache {
+public:
+    explicit SuccessorCache(size_t capacity = SUCCESSOR_CACHE_CAPACITY);
+
+    /// copy the successors stored for the node in successors and return true, or return false if none is stored
+    bool find(Node node, Array<pair<bool, Attribute>> &successors) const;
+
+    /// store the successors of the node, if they are not stored yet
+    void store(Node node, Array<pair<bool, Attribute>> successors);
+
+    /// free the successors of a node which will not be searched again
+    void release(Node node);
+
+    /// bytes drawn from the arena
+    size_t memory() const { return used; }
+
+private:
+    Arena arena;
+    vector<uint32_t*> lists; // for each node, its successor list or nullptr
+    vector<uint32_t*> freeLists[32]; // released arrays, by log2 of their capacity
+    size_t capacity;
+    size_t used = 0;
+};
+
+#endif //DL85_SUCCESSOR_CACHE_H
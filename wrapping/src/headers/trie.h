@@ -1,35 +1,86 @@
 #ifndef TRIE_H
 #define TRIE_H
 #include <vector> // we only use arrays for +- fixed sized things
+#include <cstdint>
 #include "globals.h"
-#include "query.h"
+#include "arena.h"
 
 using namespace std;
 
-struct TrieNode;
+typedef uint32_t Node; // index of a node in the trie
+
+#define NO_NODE UINT32_MAX
 
 struct TrieEdge {
   Item item;
-  TrieNode *subtrie;
+  Node subtrie;
 };
 
-struct TrieNode {
-  vector<TrieEdge> edges;
-  QueryData *data; // data used to answer a query, if null this itemset is not closed
-  ~TrieNode ();
+// edges of a node, sorted by item. The array comes from the arena of the trie and its capacity is a power of 2
+struct TrieEdges {
+  TrieEdge *elts;
+  uint32_t size;
+  uint32_t capacity;
 };
 
 
+// the nodes are stored column by column: each field of the nodes is an array indexed by the node. The fields of a
+// node without data (a prefix of an itemset that has not been explored) are not meaningful. E is the type of the
+// errors and bounds of the nodes. The errors, bounds and sizes keep their 32-bit types, so that the counted errors
+// stay exact whatever the number of transactions: the memory saved per node comes from the 32-bit node ids, the edges
+// stored without a vector header and the columns, which have no padding, and not from narrower fields. Only the
+// solution depth is 16-bit
+template<class E>
 class Trie {
-friend class Query_TotalFreq;
 public:
     Trie();
 
     ~Trie();
-    TrieNode *insert ( Array<Item> itemset );
-    TrieNode *find ( Array<Item> itemset );
-    TrieNode *root;
-    TrieNode *createTree ( Array<Item> itemset, int pos, TrieNode *&last );
+    Node insert ( Array<Item> itemset );
+    Node find ( Array<Item> itemset );
+    Node root;
+
+    // data used to answer a query. If a node has no data, its itemset is not closed
+    bool hasData ( Node node ) const { return hasDatas[node]; }
+    void setHasData ( Node node ) { hasDatas[node] = true; }
+    Attribute &test ( Node node ) { return tests[node]; } // class of a leaf or attribute of a test
+    Node &left ( Node node ) { return lefts[node]; } // NO_NODE for a leaf
+    Node &right ( Node node ) { return rights[node]; }
+    E &leafError ( Node node ) { return leafErrors[node]; }
+    E &error ( Node node ) { return errors[node]; }
+    E &initUb ( Node node ) { return initUbs[node]; }
+    E &lowerBound ( Node node ) { return lowerBounds[node]; }
+    Size &size ( Node node ) { return sizes[node]; }
+    Depth solutionDepth ( Node node ) const { return solutionDepths[node]; }
+    void setSolutionDepth ( Node node, Depth depth ) { solutionDepths[node] = (int16_t) depth; }
+
+    const TrieEdges &edges ( Node node ) const { return nodeEdges[node]; }
+
+    size_t getNNodes () const { return nodeEdges.size(); }
+
+    // bytes reserved for the nodes, their edges and their data
+    size_t memory () const;
+
+protected:
+    Node createTree ( Array<Item> itemset, int pos, Node &last );
+    Node newNode ();
+    void insertEdge ( Node node, uint32_t pos, TrieEdge edge );
+
+    Arena arena; // memory of the edges
+    vector<TrieEdge*> freeEdges[32]; // arrays of edges released when their node grew, by log2 of their capacity
+    size_t edgeMemory = 0;
+
+    ChunkedArray<TrieEdges> nodeEdges;
+    ChunkedArray<bool> hasDatas;
+    ChunkedArray<Attribute> tests;
+    ChunkedArray<Node> lefts;
+    ChunkedArray<Node> rights;
+    ChunkedArray<E> leafErrors;
+    ChunkedArray<E> errors;
+    ChunkedArray<E> initUbs;
+    ChunkedArray<E> lowerBounds;
+    ChunkedArray<Size> sizes;
+    ChunkedArray<int16_t> solutionDepths;
 };
 
 #endif